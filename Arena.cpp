@@ -0,0 +1,1017 @@
+// Arena engine: board setup, radar, shooting, movement and the match loop
+#include <bits/stdc++.h>
+#include <dlfcn.h>
+#include "Arena.h"
+#include "Board.h"
+#include "RobotTable.h"
+#include "RobotUsage.h"
+#include "Spectator.h"
+#include "ArenaPolicies.h"
+#include "CallTrace.h"
+#include "Heatmap.h"
+#include "LayoutCorpus.h"
+#include "MatchTask.h"
+
+using namespace std;
+
+static const char FLAME_OBS = 'F';
+static const char PIT_OBS = 'P';
+static const char MOUND_OBS = 'M';
+static const char* WEAPON_NAMES[] = {"flamethrower", "railgun", "grenade", "hammer"};
+
+// Engine counters. Build with -DROBOTWARZ_METRICS (make METRICS=1) to enable;
+// otherwise every COUNT() compiles away and nothing is written.
+#ifdef ROBOTWARZ_METRICS
+// Counted per thread, so interleaved matches on several threads never
+// share a counter. Finished threads and reaped workers add theirs to the
+// totals that write_metrics() reports.
+static thread_local EngineCounters g_counters;
+static EngineCounters g_counter_totals;
+static mutex g_counter_lock;
+#define COUNT(field) (++g_counters.field)
+#define COUNT_N(field, n) (g_counters.field += (n))
+#else
+#define COUNT(field) ((void)0)
+#define COUNT_N(field, n) ((void)0)
+#endif
+
+// Cells still available for placement. The board starts empty, so instead of
+// rejection sampling we do a partial Fisher-Yates shuffle over the virtual
+// array [0, rows*cols): only displaced entries are stored, so each draw is
+// O(1) regardless of board size or how full it already is.
+struct FreeCells {
+    long long remaining = 0;
+    unordered_map<long long, long long> moved;
+
+    explicit FreeCells(long long cells) : remaining(cells) {}
+
+    long long at(long long i) const {
+        auto it = moved.find(i);
+        return it == moved.end() ? i : it->second;
+    }
+
+    // Draws one cell index (row * cols + col) without replacement
+    template <class Rng>
+    long long take(Rng& gen) {
+        uniform_int_distribution<long long> dist(0, remaining - 1);
+        long long j = dist(gen);
+        long long picked = at(j);
+        moved[j] = at(remaining - 1);
+        moved.erase(remaining - 1);
+        --remaining;
+        return picked;
+    }
+};
+
+// Helper: compile a robot implementation (Robot_X.cpp) into a libRobot_X.so.
+// The library always lands in the current directory, wherever the source is.
+bool compile_robot(const string& cpp, string& out_so, const string& suffix) {
+    string base = filesystem::path(cpp).stem().string();
+    out_so = "./lib" + base + suffix + ".so";
+    string cmd = "g++ -shared -fPIC -o " + out_so + " " + cpp + " RobotBase.o -I. -std=c++20";
+    cerr << "Compiling: " << cmd << "\n";
+    return system(cmd.c_str()) == 0;
+}
+
+bool load_robot(LoadedRobot& lr) {
+    if (!compile_robot(lr.cpp_file, lr.so_file)) {
+        cerr << "Failed compiling " << lr.cpp_file << " - skipping\n";
+        return false;
+    }
+    return open_robot(lr);
+}
+
+bool open_robot(LoadedRobot& lr) {
+    lr.handle = dlopen(lr.so_file.c_str(), RTLD_LAZY);
+    if (!lr.handle) {
+        cerr << "dlopen failed for " << lr.so_file << ": " << dlerror() << "\n";
+        return false;
+    }
+
+    lr.factory = (RobotFactory)dlsym(lr.handle, "create_robot");
+    if (!lr.factory) {
+        cerr << "dlsym create_robot failed in " << lr.so_file << ": " << dlerror() << "\n";
+        dlclose(lr.handle);
+        lr.handle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void unload_robot(LoadedRobot& lr) {
+    delete lr.robot_instance;
+    lr.robot_instance = nullptr;
+    if (lr.handle) dlclose(lr.handle);
+    lr.handle = nullptr;
+    lr.factory = nullptr;
+}
+
+// Helper: Obstacles. next_cell() gives each one's cell (row * cols + col)
+// in turn: the flames, then the pits, then the mounds.
+template <class NextCell>
+void place_obstacles(Board& board, const ArenaConfig& cfg, NextCell next_cell) {
+    int cols = board.cols();
+
+    auto place = [&](char ch, int count) {
+        while (count--) {
+            long long cell = next_cell();
+            board.set((int)(cell / cols), (int)(cell % cols), ch);
+        }
+    };
+
+    place(FLAME_OBS, cfg.num_flames);
+    place(PIT_OBS, cfg.num_pits);
+    place(MOUND_OBS, cfg.num_mounds);
+}
+
+// Place robots on the board; spawn_cell(i) gives robot i's cell. Robots
+// without an instance get no cell.
+template <class Log, class SpawnCell>
+void place_robots(vector<LoadedRobot>& robots, RobotTable& table, Board& board, SpawnCell spawn_cell, Log& log) {
+    int rows = board.rows();
+    int cols = board.cols();
+
+    table.reset(robots.size());
+    for (size_t i = 0; i < robots.size(); ++i) {
+        LoadedRobot &lr = robots[i];
+        if (!lr.robot_instance) continue;
+        long long cell = spawn_cell(i);
+        int r = (int)(cell / cols);
+        int c = (int)(cell % cols);
+
+        lr.robot_instance->move_to(r,c);
+        lr.robot_instance->set_boundaries(rows, cols);
+        board.set(r, c, lr.robot_instance->m_character);
+        board.set_occupied(r, c, true);
+        table.load(i, lr.robot_instance);
+
+        log << "Loaded robot: " << lr.robot_instance->m_name
+             << " at (" << r << "," << c << ")\n";
+    }
+}
+
+// Print board nicely
+void print_board(const Board& board) {
+    int rows = board.rows();
+    int cols = board.cols();
+    cout << "\n=========== board ===========\n";
+    cout << " ";
+    for (int c = 0; c < cols; ++c) cout << setw(3) << c;
+    cout << "\n\n";
+    for (int r = 0; r < rows; ++r) {
+        cout << setw(3) << r << " ";
+        for (int c = 0; c < cols; ++c) {
+            cout << setw(3) << board.at(r, c);
+        }
+        cout << "\n\n";
+    }
+}
+
+void TerminalRenderer::end_round(const Board& board) {
+    print_board(board);
+
+    cout << "\nPress ENTER to continue to the next round...";
+    cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    cin.get(); // waits for ENTER
+}
+
+// Helper to find the index of the live robot at a position
+int find_robot_at(const RobotTable& table, int row, int col) {
+    COUNT(find_robot_at_calls);
+    return table.find_at(row, col);
+}
+
+
+void mark_robot_dead(RobotTable& table, int idx, Board& board) {
+    board.set(table.row[idx], table.col[idx], 'X');
+    board.set_occupied(table.row[idx], table.col[idx], false);
+    table.alive[idx] = 0;
+}
+
+
+// Helper: cells from (row, col) to the board edge in direction, not
+// counting the start
+int ray_length(int row, int col, int direction, int rows, int cols) {
+    auto [dr, dc] = directions[direction];
+    int steps = max(rows, cols);
+    if (dr > 0) steps = min(steps, rows - 1 - row);
+    if (dr < 0) steps = min(steps, row);
+    if (dc > 0) steps = min(steps, cols - 1 - col);
+    if (dc < 0) steps = min(steps, col);
+    return steps;
+}
+
+// Build radar results for a robot scanning in a given direction into res,
+// which the caller reuses from turn to turn
+void do_radar_scan(int scanner, int direction, const Board& board, const vector<LoadedRobot>& robots, const RobotTable& table, vector<RadarObj>& res) {
+    res.clear();
+    if (direction <= 0 || direction > 8) return;
+
+    auto report = [&](int r, int c) {
+        int idx = find_robot_at(table, r, c);
+        if (idx != -1) {
+            RobotBase* target = robots[idx].robot_instance;
+            res.emplace_back(target->m_character, r, c);
+        }
+    };
+#ifdef ROBOTWARZ_REFERENCE
+    // Reference engine (make golden): every cell of the ray
+    auto [dr, dc] = directions[direction];
+    for (int r = table.row[scanner] + dr, c = table.col[scanner] + dc; board.in_bounds(r, c); r += dr, c += dc) {
+        COUNT(radar_cells_scanned);
+        report(r, c);
+    }
+#else
+    // Only cells with a live robot can show up, so the board hands over just
+    // those and skips empty stretches of the ray a tile at a time. The
+    // counter still covers the whole ray, as a cell-by-cell scan would.
+    COUNT_N(radar_cells_scanned,
+            ray_length(table.row[scanner], table.col[scanner], direction, board.rows(), board.cols()));
+    board.for_each_occupied_on_ray(table.row[scanner], table.col[scanner], direction, report);
+#endif
+}
+
+// Helper: the same text as RobotBase::print_stats(), formatted on the stack
+// because print_stats() builds an ostringstream and a string on every call
+const char* format_stats(RobotBase* r, char* buf, size_t size) {
+    int row, col;
+    r->get_current_location(row, col);
+    snprintf(buf, size, "%s:   H: %d  W: %s  A: %d  M: %d  at: (%d,%d) ",
+             r->m_name.c_str(), r->get_health(), WEAPON_NAMES[r->get_weapon()],
+             r->get_armor(), r->get_move_speed(), row, col);
+    return buf;
+}
+
+// Apply an attack originating from shooter index; heat (may be null) gets
+// the health each target loses
+template <class Log>
+void apply_shot(vector<LoadedRobot>& robots, RobotTable& table, int shooter_idx, int shot_r, int shot_c, Board& board,
+                Heatmap* heat, Log& log) {
+    RobotBase* shooter = robots[shooter_idx].robot_instance;
+    WeaponType wt = table.weapon[shooter_idx];
+    int rows = board.rows();
+    int cols = board.cols();
+    COUNT(shots[wt]);
+
+    if (shot_r < 0 || shot_r >= rows || shot_c < 0 || shot_c >= cols) {
+        log << shooter->m_name << " fired an invalid shot.\n";
+        return;
+    }
+
+    auto damage_hit = [&](int target_idx, int dmg) {
+        if (target_idx < 0) return;
+        RobotBase* target = robots[target_idx].robot_instance;
+        if (!table.alive[target_idx]) return;
+        COUNT(hits);
+
+        target->reduce_armor(1);
+        int newh = target->take_damage(dmg);
+        if (heat) heat->add(HEAT_DAMAGE, table.row[target_idx], table.col[target_idx], table.health[target_idx] - newh);
+        table.armor[target_idx] = target->get_armor();
+        table.health[target_idx] = newh;
+
+        log << "Shooting: " << shooter->m_name
+             << " hits " << target->m_name
+             << " for " << dmg << " damage. Health: " << newh << "\n";
+
+        if (newh <= 0) {
+            mark_robot_dead(table, target_idx, board);
+            log << target->m_name << " is dead.\n";
+        }
+    };
+
+    switch (wt) {
+        case railgun: {
+            for (size_t i = 0; i < table.size(); ++i) {
+                if (!table.alive[i]) continue;
+                if ((int)i == shooter_idx) continue;  // skip the shooter
+
+                // Hit if on the same row OR same column as the target
+                if (table.row[i] == shot_r || table.col[i] == shot_c) {
+                    damage_hit((int)i, 12);
+                }
+            }
+            break;
+        }
+
+
+        case flamethrower: {
+            // Mark the flamethrower area as flames and damage any robots inside.
+            // The existing loops already iterate the intended box: rows [shot_r-2 .. shot_r+1], cols [shot_c-1 .. shot_c+1]
+            for (int r = shot_r - 2; r <= shot_r + 1; ++r) {
+                for (int c = shot_c - 1; c <= shot_c + 1; ++c) {
+                    if (r < 0 || r >= rows || c < 0 || c >= cols) continue;
+                    // Place flame on the board
+                    board.set(r, c, FLAME_OBS);
+                    // If there's a robot there, damage it
+                    int idx = find_robot_at(table, r, c);
+                    if (idx != -1) damage_hit(idx, 8);
+                }
+            }
+            break;
+        }
+
+        case grenade: {
+            if (table.grenades[shooter_idx] <= 0) {
+                log << shooter->m_name << " has no grenades left!\n";
+                break;
+            }
+            for (int r = shot_r - 1; r <= shot_r + 1; ++r) {
+                for (int c = shot_c - 1; c <= shot_c + 1; ++c) {
+                    if (r < 0 || r >= rows || c < 0 || c >= cols) continue;
+                    int idx = find_robot_at(table, r, c);
+                    if (idx != -1) damage_hit(idx, 18);
+                }
+            }
+            shooter->decrement_grenades();
+            table.grenades[shooter_idx] = shooter->get_grenades();
+            break;
+        }
+        case hammer: {
+            int idx = find_robot_at(table, shot_r, shot_c);
+            if (idx != -1) damage_hit(idx, 20);
+            break;
+        }
+    }
+}
+
+// Helper: (health, armor) for stalemate tiebreaks
+pair<int, int> vital_signs(const RobotTable& table, size_t i) {
+    return {table.health[i], table.armor[i]};
+}
+
+// Helper: why a robot's usage breaks the configured caps, or null if it does not
+const char* over_cap(const RobotUsage& u, const ArenaConfig& cfg) {
+    if (cfg.cpu_cap_sec > 0 && u.cpu_sec > cfg.cpu_cap_sec) return "over the CPU time cap";
+    if (cfg.heap_cap_bytes > 0 && u.heap_peak > cfg.heap_cap_bytes) return "over the heap cap";
+    return nullptr;
+}
+
+// Helper: one robot's usage for the end-of-game summary, formatted on the stack
+const char* format_usage(const RobotUsage& u, char* buf, size_t size) {
+    int n = u.cpu_sec > 0 ? snprintf(buf, size, "%.3f ms CPU, ", u.cpu_sec * 1e3) : 0;
+    snprintf(buf + n, size - n, "%.1f KB heap (peak %.1f KB), %llu allocations",
+             u.heap_bytes / 1024.0, u.heap_peak / 1024.0, u.allocations);
+    return buf;
+}
+
+char get_under_cell(const Board& board, int r, int c) {
+    char ch = board.at(r, c);
+    if (ch == FLAME_OBS || ch == PIT_OBS || ch == MOUND_OBS || ch == 'X') return ch;
+    return '.';
+}
+
+#ifdef ROBOTWARZ_METRICS
+// Dump the engine counters in Prometheus text format
+void write_metrics(const string& path, double elapsed_sec) {
+    ofstream out(path);
+    if (!out) {
+        cerr << "Could not write metrics to " << path << "\n";
+        return;
+    }
+
+    add_engine_counters(take_engine_counters());
+    EngineCounters totals;
+    {
+        lock_guard<mutex> guard(g_counter_lock);
+        totals = g_counter_totals;
+    }
+
+    auto counter = [&](const char* name, const char* help, unsigned long long value) {
+        out << "# HELP robotwarz_" << name << " " << help << "\n";
+        out << "# TYPE robotwarz_" << name << " counter\n";
+        out << "robotwarz_" << name << " " << value << "\n";
+    };
+
+    counter("radar_cells_scanned_total", "Board cells visited by radar scans.", totals.radar_cells_scanned);
+    counter("find_robot_at_calls_total", "Calls to find_robot_at.", totals.find_robot_at_calls);
+
+    out << "# HELP robotwarz_shots_total Shots fired, by weapon.\n";
+    out << "# TYPE robotwarz_shots_total counter\n";
+    for (int w = 0; w < 4; ++w)
+        out << "robotwarz_shots_total{weapon=\"" << WEAPON_NAMES[w] << "\"} " << totals.shots[w] << "\n";
+
+    counter("hits_total", "Robots damaged by shots.", totals.hits);
+    counter("blocked_moves_total", "Moves stopped by an edge, mound, wreck or robot.", totals.blocked_moves);
+    counter("flame_events_total", "Robots that moved onto a flame.", totals.flame_events);
+    counter("pit_events_total", "Robots that fell into a pit.", totals.pit_events);
+    counter("turns_total", "Robot turns played.", totals.turns);
+    counter("rounds_total", "Rounds played.", totals.rounds);
+
+    out << "# HELP robotwarz_rounds_per_second Rounds played per wall-clock second.\n";
+    out << "# TYPE robotwarz_rounds_per_second gauge\n";
+    out << "robotwarz_rounds_per_second " << (elapsed_sec > 0 ? totals.rounds / elapsed_sec : 0.0) << "\n";
+}
+#else
+void write_metrics(const string&, double) {}
+#endif
+
+EngineCounters& EngineCounters::operator+=(const EngineCounters& o) {
+    radar_cells_scanned += o.radar_cells_scanned;
+    find_robot_at_calls += o.find_robot_at_calls;
+    for (int w = 0; w < 4; ++w) shots[w] += o.shots[w];
+    hits += o.hits;
+    blocked_moves += o.blocked_moves;
+    flame_events += o.flame_events;
+    pit_events += o.pit_events;
+    turns += o.turns;
+    rounds += o.rounds;
+    return *this;
+}
+
+EngineCounters take_engine_counters() {
+#ifdef ROBOTWARZ_METRICS
+    return exchange(g_counters, EngineCounters());
+#else
+    return EngineCounters();
+#endif
+}
+
+void add_engine_counters([[maybe_unused]] const EngineCounters& counters) {
+#ifdef ROBOTWARZ_METRICS
+    lock_guard<mutex> guard(g_counter_lock);
+    g_counter_totals += counters;
+#endif
+}
+
+// Trace format (compared line by line by TraceDiff):
+//   M seed rows cols robots      match header
+//   T round robot radar DIR [ch@r,c ...] shot 0|1 R C move DIR DIST | r,c,health,armor,alive ...
+//   B round                      end-of-round board dump, one line per row
+//   G rounds winner stalemate    game over
+// Each T line ends with every robot's state after the turn, so a change
+// in radar, shooting or movement shows up on the turn that caused it.
+static void trace_board(ostream& out, const Board& board, int round) {
+    out << "B " << round << "\n";
+    for (int r = 0; r < board.rows(); ++r) {
+        for (int c = 0; c < board.cols(); ++c) out << board.at(r, c);
+        out << "\n";
+    }
+}
+
+// One T line per turn, plus the robot's call-trace record when calls is
+// set, written when the turn ends however it ends
+struct TurnTrace {
+    ostream* out;
+    int round;
+    size_t robot;
+    const RobotTable& table;
+    const vector<RadarObj>& radar_results;
+    int radar_dir = 0;
+    bool shooting = false;
+    int shot_r = -1, shot_c = -1;
+    int move_dir = 0, move_dist = 0;
+    CallTraceWriter* calls = nullptr;
+    CallTurn call{};
+
+    ~TurnTrace() {
+        if (calls) {
+            call.round = round;
+            call.radar_dir = (int8_t)radar_dir;
+            call.shooting = shooting;
+            call.shot_r = (int16_t)shot_r;
+            call.shot_c = (int16_t)shot_c;
+            call.move_dir = (int8_t)move_dir;
+            call.move_dist = (int8_t)move_dist;
+            calls->write(call, radar_results);
+        }
+        if (!out) return;
+        *out << "T " << round << " " << robot << " radar " << radar_dir;
+        for (auto &o : radar_results) *out << " " << o.m_type << "@" << o.m_row << "," << o.m_col;
+        *out << " shot " << shooting << " " << shot_r << " " << shot_c
+             << " move " << move_dir << " " << move_dist << " |";
+        for (size_t j = 0; j < table.size(); ++j) {
+            *out << " " << table.row[j] << "," << table.col[j] << "," << table.health[j]
+                 << "," << table.armor[j] << "," << (int)table.alive[j];
+        }
+        *out << "\n";
+    }
+};
+
+// Adds the time until the end of its scope to one PhaseTimes field
+template <class Clock>
+struct PhaseTimer {
+    double* slot;
+    typename Clock::time_point start;
+
+    PhaseTimer(PhaseTimes* times, double PhaseTimes::*field) : slot(&(times->*field)), start(Clock::now()) {}
+    ~PhaseTimer() { *slot += Clock::seconds_since(start); }
+};
+
+// Untimed builds: nothing to construct, nothing to read
+template <>
+struct PhaseTimer<NullClock> {
+    PhaseTimer(PhaseTimes*, double PhaseTimes::*) {}
+};
+
+// One match, suspending after every round; see Arena.h
+template <class Policies>
+MatchTask match_rounds(vector<LoadedRobot>& robots, const ArenaConfig& cfg, MatchResult& result) {
+    using Clock = typename Policies::Clock;
+    typename Policies::Logger log;
+    typename Policies::Renderer renderer;
+
+    result = MatchResult();
+
+    // Every obstacle and robot needs its own cell
+    long long cells = (long long)cfg.rows * cfg.cols;
+    long long needed = (long long)cfg.num_flames + cfg.num_pits + cfg.num_mounds + (long long)robots.size();
+    if (needed > cells) {
+        cerr << "Arena too small: " << needed << " obstacles and robots for " << cells << " cells.\n";
+        co_return false;
+    }
+    Heatmap* heat = cfg.heatmap;
+    if (heat && !heat->fits(cfg.rows, cfg.cols)) {
+        cerr << "The heatmap is for a different board size than " << cfg.rows << "x" << cfg.cols << ".\n";
+        co_return false;
+    }
+
+    // Everything that can fail is set up before any robot is built, so a
+    // failed match leaves no instances behind
+    const uint64_t* layout = nullptr;
+    if (cfg.layouts) {
+        layout = cfg.layouts->layout_for(cfg, robots.size());
+        if (!layout) co_return false;
+    }
+    ofstream trace_out;
+    ostream* trace = nullptr;
+    if (!cfg.trace_file.empty()) {
+        trace_out.open(cfg.trace_file);
+        if (!trace_out) {
+            cerr << "Could not write trace file " << cfg.trace_file << "\n";
+            co_return false;
+        }
+        trace = &trace_out;
+    }
+    vector<CallTraceWriter> call_traces;
+    if (!cfg.call_trace_dir.empty()) {
+        error_code ec;
+        filesystem::create_directories(cfg.call_trace_dir, ec);
+        call_traces.resize(robots.size());
+        for (size_t i = 0; i < robots.size(); ++i) {
+            string stem = filesystem::path(robots[i].cpp_file).stem().string();
+            string path = (filesystem::path(cfg.call_trace_dir) / (stem + ".calls")).string();
+            if (!call_traces[i].open(path, stem, cfg.rows, cfg.cols, cfg.seed, (int)i)) {
+                cerr << "Could not write call trace " << path << "\n";
+                co_return false;
+            }
+        }
+    }
+
+    // Fresh instances and per-match state for every robot. Constructors
+    // are robot code too, so what they allocate is charged to the robot.
+    vector<RobotUsage> usage(robots.size());
+    vector<RobotRandom> random(robots.size());
+    for (size_t i = 0; i < robots.size(); ++i) random[i] = robot_random(cfg.seed, (int)i);
+    bool measure_cpu = cfg.report_usage || cfg.cpu_cap_sec > 0;
+    bool capped = cfg.cpu_cap_sec > 0 || cfg.heap_cap_bytes > 0;
+    for (size_t i = 0; i < robots.size(); ++i) {
+        LoadedRobot& lr = robots[i];
+        {
+            RobotCodeScope in_robot(usage[i], random[i], measure_cpu);
+            lr.robot_instance = lr.factory ? lr.factory() : nullptr;
+        }
+        if (!lr.robot_instance) cerr << "create_robot returned null for " << lr.so_file << "\n";
+    }
+
+    // Initialize board and obstacles: a stored layout, or random free cells
+    const int rows = cfg.rows;
+    const int cols = cfg.cols;
+    Board board(rows, cols);
+    RobotTable table;
+    if (layout) {
+        const uint64_t* spawns = layout + cfg.num_flames + cfg.num_pits + cfg.num_mounds;
+        place_obstacles(board, cfg, [&] { return (long long)*layout++; });
+        place_robots(robots, table, board, [&](size_t i) { return (long long)spawns[i]; }, log);
+    } else {
+        typename Policies::Rng gen(cfg.seed);
+        FreeCells free_cells(cells);
+        place_obstacles(board, cfg, [&] { return free_cells.take(gen); });
+        place_robots(robots, table, board, [&](size_t) { return free_cells.take(gen); }, log);
+    }
+    if (cfg.spectator) cfg.spectator->begin_match(board, table, robots);
+
+    if (trace) {
+        *trace << "M " << cfg.seed << " " << rows << " " << cols << " " << robots.size() << "\n";
+        trace_board(*trace, board, -1);
+    }
+
+    // Buffers reused every turn so the loop below does not allocate
+    vector<RadarObj> radar_results;
+    radar_results.reserve(max(8, max(rows, cols)));
+    char stats_buf[256];
+
+    int round = 0;
+
+    // Stalemate detection: health and armor only ever go down, so damage
+    // makes every earlier state unreachable. Only states since the last
+    // damage need to be remembered.
+    RepetitionTable seen_states;
+    long long last_vitality = LLONG_MAX;
+    int quiet_since = 0;
+
+    // Timed variants need somewhere to put the times even if the caller
+    // did not ask for them
+    PhaseTimes unused_times;
+    PhaseTimes* times = cfg.phase_times ? cfg.phase_times : &unused_times;
+    optional<PhaseTimer<Clock>> loop_time;
+    loop_time.emplace(times, &PhaseTimes::total);
+
+    bool alloc_check_failed = false;
+    while (true) {
+        [[maybe_unused]] unsigned long long allocs_before = arena_allocations();
+        log << "\n=========== starting round " << round << " ===========\n";
+        
+
+        // --- Each robot takes a turn ---
+        for (size_t i = 0; i < robots.size(); ++i) {
+            if (!table.alive[i]) continue;
+
+            RobotBase* r = robots[i].robot_instance;
+            COUNT(turns);
+            if constexpr (Clock::enabled) times->turns++;
+            radar_results.clear();
+            TurnTrace turn{trace, round, i, table, radar_results};
+            if (!call_traces.empty()) {
+                turn.calls = &call_traces[i];
+                turn.call.state = call_state(r);
+            }
+            log << "\n" << r->m_name << " " << r->m_character << " begins turn.\n";
+            if constexpr (Policies::Logger::enabled) log << format_stats(r, stats_buf, sizeof stats_buf) << "\n";
+
+            // Radar scanning
+            int radar_dir = 0;
+            {
+                RobotCodeScope in_robot(usage[i], random[i], measure_cpu);
+                PhaseTimer<Clock> robot_time(times, &PhaseTimes::robot);
+                r->get_radar_direction(radar_dir);
+            }
+            turn.radar_dir = radar_dir;
+
+            if (radar_dir == 0) {
+                PhaseTimer<Clock> radar_time(times, &PhaseTimes::radar);
+                int rr = table.row[i], rc = table.col[i];
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        if (dr == 0 && dc == 0) continue;
+                        int nr = rr + dr, nc = rc + dc;
+                        if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
+                        COUNT(radar_cells_scanned);
+                        int idx = find_robot_at(table, nr, nc);
+                        if (idx != -1) radar_results.emplace_back(robots[idx].robot_instance->m_character, nr, nc);
+                    }
+                }
+            } else {
+                PhaseTimer<Clock> radar_time(times, &PhaseTimes::radar);
+                do_radar_scan((int)i, radar_dir, board, robots, table, radar_results);
+            }
+
+            // Shooting
+            int shot_r = -1, shot_c = -1;
+            bool shooting;
+            {
+                RobotCodeScope in_robot(usage[i], random[i], measure_cpu);
+                PhaseTimer<Clock> robot_time(times, &PhaseTimes::robot);
+                r->process_radar_results(radar_results);
+                shooting = r->get_shot_location(shot_r, shot_c);
+            }
+            turn.shooting = shooting;
+            turn.shot_r = shot_r;
+            turn.shot_c = shot_c;
+            if (shooting) {
+                {
+                    PhaseTimer<Clock> shot_time(times, &PhaseTimes::shooting);
+                    apply_shot(robots, table, (int)i, shot_r, shot_c, board, heat, log);
+                }
+                if (!table.alive[i]) {
+                    log << r->m_name << " died from shooting damage. Skipping turn.\n";
+                    continue;
+                }
+            }
+
+            // --- Movement ---
+            if (!table.can_move[i]) {
+                log << r->m_name << " is trapped in a pit and cannot move.\n";
+                continue;
+            }
+
+            // Get move attempt
+            int move_dir = 0, move_dist = 0;
+            if (turn.calls) {
+                turn.call.asked_move = 1;
+                turn.call.move_state = call_state(r);
+            }
+            {
+                RobotCodeScope in_robot(usage[i], random[i], measure_cpu);
+                PhaseTimer<Clock> robot_time(times, &PhaseTimes::robot);
+                r->get_move_direction(move_dir, move_dist);
+            }
+            turn.move_dir = move_dir;
+            turn.move_dist = move_dist;
+            PhaseTimer<Clock> move_time(times, &PhaseTimes::movement); // rest of the turn
+
+            // Validate move attempt
+            if (move_dir < 1 || move_dir > 8 || move_dist <= 0 || move_dist > r->get_move_speed()) {
+                log << r->m_name << " chose invalid move (" << move_dir << "," << move_dist << "). Staying put this turn.\n";
+                continue; // robot will try again next turn
+            }
+
+            int cur_r = table.row[i], cur_c = table.col[i];
+#ifdef ROBOTWARZ_REFERENCE
+            // Reference engine (make golden): step until an edge, mound,
+            // wreck or live robot is in the way
+            int dr = directions[move_dir].first;
+            int dc = directions[move_dir].second;
+            int new_r = cur_r, new_c = cur_c;
+            bool blocked = false;
+            for (int step = 0; step < move_dist; ++step) {
+                int tr = new_r + dr;
+                int tc = new_c + dc;
+                if (!board.in_bounds(tr, tc) || board.at(tr, tc) == MOUND_OBS || board.at(tr, tc) == 'X'
+                    || find_robot_at(table, tr, tc) != -1) {
+                    blocked = true;
+                    break;
+                }
+                new_r = tr;
+                new_c = tc;
+            }
+#else
+            // Attempt move: the board's free-distance table says how far the
+            // robot can go before an edge, mound, wreck or robot, so the whole
+            // path is checked at once. A blocked move stops at the last open
+            // cell for the log and the robot stays put.
+            int free_dist = board.reach(cur_r, cur_c, move_dir);
+            bool blocked = move_dist > free_dist;
+            int steps = blocked ? free_dist : move_dist;
+            int new_r = cur_r + directions[move_dir].first * steps;
+            int new_c = cur_c + directions[move_dir].second * steps;
+#endif
+
+            if (blocked) {
+                COUNT(blocked_moves);
+                log << "Moving: " << r->m_name << " blocked at (" << new_r << "," << new_c << "). Staying put this turn.\n";
+                board.set(cur_r, cur_c, r->m_character); // leave robot in place
+                // do NOT clear can_move; robot will attempt again next turn
+            } else {
+                // Valid move
+                char landed_cell = board.at(new_r, new_c);
+                board.set(cur_r, cur_c, get_under_cell(board, cur_r, cur_c));
+                r->move_to(new_r, new_c);
+                board.set_occupied(cur_r, cur_c, false);
+                board.set_occupied(new_r, new_c, true);
+                table.row[i] = new_r;
+                table.col[i] = new_c;
+                log << "Moving: " << r->m_name << " moves to (" << new_r << "," << new_c << ").\n";
+
+                if (landed_cell == FLAME_OBS) {
+                    COUNT(flame_events);
+                    r->reduce_armor(1);
+                    int health = r->take_damage(8);
+                    if (heat) {
+                        heat->add(HEAT_FLAME_HITS, new_r, new_c);
+                        heat->add(HEAT_DAMAGE, new_r, new_c, table.health[i] - health);
+                    }
+                    table.armor[i] = r->get_armor();
+                    table.health[i] = health;
+                    if (health <= 0) {
+                        mark_robot_dead(table, (int)i, board);
+                        log << r->m_name << " died in flames.\n";
+                        continue;
+                    }
+                }
+
+                board.set(new_r, new_c, r->m_character);
+
+                if (landed_cell == PIT_OBS) {
+                    COUNT(pit_events);
+                    if (heat) heat->add(HEAT_PIT_TRAPS, new_r, new_c);
+                    table.can_move[i] = 0; // only permanent if actually in pit
+                    r->disable_movement();
+                    log << r->m_name << " fell into a pit and cannot move for the rest of the game!\n";
+                }
+            }
+
+
+            // Final alive check
+            if (table.health[i] <= 0) {
+                mark_robot_dead(table, (int)i, board);
+                log << r->m_name << " has died.\n";
+                continue;
+            } if (table.alive[i]) {
+                board.set(table.row[i], table.col[i], r->m_character);
+            }
+        } // end robot loop
+        COUNT(rounds);
+
+        // --- Resource caps ---
+        if (capped) {
+            for (size_t i = 0; i < robots.size(); ++i) {
+                if (!table.alive[i]) continue;
+                const char* reason = over_cap(usage[i], cfg);
+                if (!reason) continue;
+                mark_robot_dead(table, (int)i, board);
+                log << robots[i].robot_instance->m_name << " is disqualified: " << reason << ".\n";
+            }
+        }
+
+        // --- End-of-round check ---
+        int alive_count = 0;
+        int last_alive = -1;
+        unsigned long long state = board.hash();
+        long long vitality = 0;
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (table.alive[i]) {
+                alive_count++;
+                last_alive = (int)i; // keep track of last alive robot
+                state ^= zobrist_robot_key((int)i, table.row[i], table.col[i],
+                                           table.health[i], table.armor[i], table.grenades[i]);
+                vitality += table.health[i] + table.armor[i];
+                if (heat) heat->add(HEAT_OCCUPANCY, table.row[i], table.col[i]);
+            } else if (robots[i].robot_instance && table.died_round[i] < 0) {
+                table.died_round[i] = round;
+                if (heat) heat->add(HEAT_DEATHS, table.row[i], table.col[i]);
+            }
+        }
+
+        if (vitality < last_vitality) {
+            last_vitality = vitality;
+            quiet_since = round;
+            seen_states.reset();
+        }
+        int repeats = seen_states.record(state);
+
+        if (alive_count > 1 && cfg.repeat_limit > 0 && repeats >= cfg.repeat_limit) {
+            log << "\nStalemate: the same position has come up " << repeats << " times without damage.\n";
+            result.stalemate = true;
+        } else if (alive_count > 1 && cfg.stall_rounds > 0 && round - quiet_since >= cfg.stall_rounds) {
+            log << "\nStalemate: no damage dealt for " << cfg.stall_rounds << " rounds.\n";
+            result.stalemate = true;
+        }
+
+        // Tiebreak: the healthiest survivor (then most armor) takes a stalled game
+        if (result.stalemate && cfg.tiebreak) {
+            int leader = -1;
+            bool tied = false;
+            for (size_t i = 0; i < table.size(); ++i) {
+                if (!table.alive[i]) continue;
+                if (leader < 0 || vital_signs(table, i) > vital_signs(table, leader)) {
+                    leader = (int)i;
+                    tied = false;
+                } else if (vital_signs(table, i) == vital_signs(table, leader)) {
+                    tied = true;
+                }
+            }
+            if (!tied) {
+                alive_count = 1;
+                last_alive = leader;
+            }
+        }
+
+        if (cfg.spectator) cfg.spectator->end_round(round, board, table, robots);
+        if (trace) trace_board(*trace, board, round);
+
+#ifdef ROBOTWARZ_ALLOC_CHECK
+        unsigned long long round_allocs = arena_allocations() - allocs_before;
+        if (round_allocs != 0) {
+            cerr << "Allocation check failed: " << round_allocs << " arena allocations in round " << round << "\n";
+            alloc_check_failed = true;
+            break;
+        }
+#endif
+
+        if (alive_count <= 1 || round >= cfg.max_rounds || result.stalemate) {
+            log << "\nGame over after " << round << " rounds.\n";
+            result.rounds = round;
+
+            if (alive_count == 1 && last_alive >= 0) {
+                result.winner = last_alive;
+                RobotBase* winner = robots[last_alive].robot_instance;
+                log << "Winner: " << winner->m_name
+                    << " (" << winner->m_character << ")!\n";
+            } else {
+                log << "No winner.\n";
+            }
+            if (cfg.spectator) cfg.spectator->end_match(round, result.winner);
+            if (heat) heat->add_game();
+            if (trace) *trace << "G " << round << " " << result.winner << " " << result.stalemate << "\n";
+
+            for (size_t i = 0; i < robots.size(); ++i) {
+                RobotBase* rb = robots[i].robot_instance;
+                if (!rb) continue;
+                log << rb->m_name << " (" << rb->m_character << ") "
+                    << (table.alive[i] ? "alive" : "dead")
+                    << " at (" << table.row[i] << "," << table.col[i] << ")\n";
+            }
+            if (cfg.report_usage || capped) {
+                for (size_t i = 0; i < robots.size(); ++i) {
+                    if (!robots[i].robot_instance) continue;
+                    log << robots[i].robot_instance->m_name << " used "
+                        << format_usage(usage[i], stats_buf, sizeof stats_buf) << "\n";
+                }
+            }
+            break;
+        }
+        
+        renderer.end_round(board);
+
+        round++;
+        co_await suspend_always{};
+    } // end while
+    loop_time.reset();
+
+    // Finishing places: survivors first, then by how late each robot died.
+    // Survivors of a tiebroken stalemate are ranked by health and armor.
+    for (size_t i = 0; i < robots.size(); ++i) {
+        int better = 0;
+        for (size_t j = 0; j < robots.size(); ++j) {
+            if (!robots[j].robot_instance) continue;
+            if (table.alive[i]) {
+                if (cfg.tiebreak && result.stalemate && table.alive[j]
+                    && vital_signs(table, j) > vital_signs(table, i)) better++;
+            } else if (table.alive[j] || table.died_round[j] > table.died_round[i]) {
+                better++;
+            }
+        }
+        result.place.push_back(robots[i].robot_instance ? better : (int)robots.size());
+    }
+    result.usage = usage;
+
+    for (auto &lr : robots) {
+        delete lr.robot_instance;
+        lr.robot_instance = nullptr;
+    }
+    co_return !alloc_check_failed;
+}
+
+template MatchTask match_rounds<HeadlessArena>(vector<LoadedRobot>&, const ArenaConfig&, MatchResult&);
+
+// Play one match to completion; see Arena.h
+template <class Policies>
+bool run_match_with(vector<LoadedRobot>& robots, const ArenaConfig& cfg, MatchResult& result) {
+    // Quiet matches send the game log nowhere, along with anything the
+    // robots themselves print
+    streambuf* saved_cout = cout.rdbuf();
+    if (cfg.quiet) cout.rdbuf(nullptr);
+    struct RestoreCout {
+        streambuf* buf;
+        ~RestoreCout() { cout.clear(); cout.rdbuf(buf); }
+    } restore_cout{saved_cout};
+
+    MatchTask match = match_rounds<Policies>(robots, cfg, result);
+    while (match.resume()) {}
+    return match.ok();
+}
+
+template bool run_match_with<InteractiveArena>(vector<LoadedRobot>&, const ArenaConfig&, MatchResult&);
+template bool run_match_with<LoggedArena>(vector<LoadedRobot>&, const ArenaConfig&, MatchResult&);
+template bool run_match_with<HeadlessArena>(vector<LoadedRobot>&, const ArenaConfig&, MatchResult&);
+template bool run_match_with<ProfiledArena>(vector<LoadedRobot>&, const ArenaConfig&, MatchResult&);
+
+// The flags pick a variant once per match; see Arena.h
+bool run_match(vector<LoadedRobot>& robots, const ArenaConfig& cfg, MatchResult& result) {
+    if (cfg.phase_times) return run_match_with<ProfiledArena>(robots, cfg, result);
+    if (!cfg.headless) return run_match_with<InteractiveArena>(robots, cfg, result);
+    if (cfg.quiet) return run_match_with<HeadlessArena>(robots, cfg, result);
+    return run_match_with<LoggedArena>(robots, cfg, result);
+}
+
+// Draws what match_rounds() draws for a full roster; see LayoutCorpus.h
+bool write_layout_corpus(const string& path, const ArenaConfig& cfg, int robots, uint64_t count) {
+    long long cells = (long long)cfg.rows * cfg.cols;
+    long long needed = (long long)cfg.num_flames + cfg.num_pits + cfg.num_mounds + robots;
+    if (needed > cells) {
+        cerr << "Arena too small: " << needed << " obstacles and robots for " << cells << " cells.\n";
+        return false;
+    }
+
+    ofstream out(path, ios::binary);
+    if (!out) {
+        cerr << "Could not write layout corpus " << path << "\n";
+        return false;
+    }
+    LayoutCorpusHeader header{{'R', 'W', 'L', 'C'}, LAYOUT_CORPUS_VERSION, 0, cfg.rows, cfg.cols,
+                              cfg.num_flames, cfg.num_pits, cfg.num_mounds, robots, cfg.seed,
+                              (uint32_t)needed, count};
+    out.write((const char*)&header, sizeof header);
+
+    vector<uint64_t> record(needed), sorted;
+    for (uint64_t k = 0; k < count; ++k) {
+        HeadlessArena::Rng gen(cfg.seed + (unsigned)k);
+        FreeCells free_cells(cells);
+        for (auto &cell : record) cell = (uint64_t)free_cells.take(gen);
+
+        // Every cell on the board and used once
+        sorted = record;
+        sort(sorted.begin(), sorted.end());
+        if (sorted.back() >= (uint64_t)cells || adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+            cerr << "Layout " << k << " failed validation\n";
+            return false;
+        }
+        out.write((const char*)record.data(), record.size() * sizeof(uint64_t));
+    }
+    if (!out.flush()) {
+        cerr << "Could not write layout corpus " << path << "\n";
+        return false;
+    }
+    return true;
+}
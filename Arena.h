@@ -0,0 +1,144 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "RobotBase.h"
+#include "RadarObj.h"
+#include "RobotUsage.h"
+
+class Heatmap;
+class LayoutCorpus;
+class MatchTask;
+class ResultCache;
+class SpectatorServer;
+
+// A robot library plus the instance playing the current match. The handle
+// and factory stay loaded across matches; robot_instance is created fresh by
+// run_match() and deleted again when the match ends. Per-match arena state
+// (alive, trapped, ...) lives in the match's RobotTable.
+struct LoadedRobot {
+    std::string cpp_file;
+    std::string so_file;
+    void* handle = nullptr;
+    RobotFactory factory = nullptr;
+    RobotBase* robot_instance = nullptr;
+};
+
+// Where matches spent their time, in seconds. run_match() adds to these
+// when ArenaConfig::phase_times is set, so one PhaseTimes can sum a batch.
+// The arena phases exclude robot code; whatever is left of `total` is
+// game logging and end-of-round bookkeeping.
+struct PhaseTimes {
+    double total = 0;               // the whole round loop
+    double robot = 0;               // inside robot callbacks
+    double radar = 0;               // arena side of radar scans
+    double shooting = 0;            // resolving shots
+    double movement = 0;            // resolving moves, landing effects included
+    long long turns = 0;
+};
+
+// Engine counters behind the metrics dump. Only builds with
+// ROBOTWARZ_METRICS (make METRICS=1) count anything; the rest leave these
+// at zero. Each thread counts into its own copy. A thread's counts reach
+// the metrics dump once it hands them to add_engine_counters(), and a
+// forked worker's once the parent does that for it.
+struct EngineCounters {
+    unsigned long long radar_cells_scanned = 0;
+    unsigned long long find_robot_at_calls = 0;
+    unsigned long long shots[4] = {};   // indexed by WeaponType
+    unsigned long long hits = 0;
+    unsigned long long blocked_moves = 0;
+    unsigned long long flame_events = 0;
+    unsigned long long pit_events = 0;
+    unsigned long long turns = 0;
+    unsigned long long rounds = 0;
+
+    EngineCounters& operator+=(const EngineCounters& o);
+};
+
+// Arena parameters. Defaults match the original fixed 20x20 layout.
+struct ArenaConfig {
+    int rows = 20;
+    int cols = 20;
+    int num_flames = 10;
+    int num_pits = 2;
+    int num_mounds = 10;
+    int max_rounds = 5000;
+    int stall_rounds = 500;         // end the game after this many rounds without damage (0 = never)
+    int repeat_limit = 100;         // end the game when a position recurs this often (0 = never)
+    bool tiebreak = false;          // stalemates go to the healthiest survivor instead of a draw
+    unsigned seed = 0;
+    bool headless = false;          // no board printing or ENTER prompts
+    bool quiet = false;             // discard the per-turn game log
+    std::string metrics_file = "robotwarz_metrics.prom";
+    SpectatorServer* spectator = nullptr;   // stream rounds to live viewers
+    std::string trace_file;         // per-turn event trace for TraceDiff (empty = off)
+    PhaseTimes* phase_times = nullptr;      // time the match phases (adds a clock read per phase)
+    std::string call_trace_dir;     // record each robot's callback inputs for RobotReplay (empty = off)
+    bool report_usage = false;      // print each robot's CPU time and heap at game over
+    double cpu_cap_sec = 0;         // disqualify a robot whose callbacks use more CPU time (0 = no cap)
+    long long heap_cap_bytes = 0;   // disqualify a robot whose heap peaks above this (0 = no cap)
+    ResultCache* cache = nullptr;   // reuse stored results in batches and the ladder (run_match ignores it)
+    const LayoutCorpus* layouts = nullptr;  // start from a stored layout instead of drawing one
+    unsigned long long layout_index = 0;    // which one; batches and the ladder use the game number
+    Heatmap* heatmap = nullptr;     // add per-cell occupancy, damage and death counts (same board size)
+};
+
+// Outcome of one match. place[i] is the finishing position of robots[i]:
+// 0 for robots alive at the end, then later deaths ahead of earlier ones.
+// Robots that died in the same round share a place. Robots over a CPU or
+// heap cap are disqualified at the end of the round and place as deaths.
+struct MatchResult {
+    int rounds = 0;
+    int winner = -1;                // index into robots, -1 for no winner
+    bool stalemate = false;         // ended early by stalemate detection
+    std::vector<int> place;
+    std::vector<RobotUsage> usage;  // per robot; cpu_sec is 0 unless measured
+};
+
+// compile a Robot_X.cpp into ./libRobot_X<suffix>.so
+bool compile_robot(const std::string& cpp, std::string& out_so, const std::string& suffix = "");
+
+// compile, dlopen and look up create_robot for lr.cpp_file
+bool load_robot(LoadedRobot& lr);
+
+// dlopen an already built lr.so_file and look up create_robot
+bool open_robot(LoadedRobot& lr);
+
+// delete any live instance and dlclose the library
+void unload_robot(LoadedRobot& lr);
+
+// Play one full match between the given robots. Fresh instances are created
+// from each robot's factory and deleted afterwards. Returns false if the
+// match could not be set up (e.g. more obstacles and robots than cells).
+// Picks the run_match_with() variant that cfg asks for: ProfiledArena when
+// phase_times is set, InteractiveArena unless headless, then HeadlessArena
+// for quiet matches and LoggedArena for the rest.
+bool run_match(std::vector<LoadedRobot>& robots, const ArenaConfig& cfg, MatchResult& result);
+
+// run_match() with the logger, renderer, RNG and clock fixed at compile time
+// (see ArenaPolicies.h). Instantiated in Arena.cpp for the variants named
+// there. cfg.headless and cfg.phase_times are ignored in favour of the
+// policies; cfg.quiet still silences anything the robots print.
+template <class Policies>
+bool run_match_with(std::vector<LoadedRobot>& robots, const ArenaConfig& cfg, MatchResult& result);
+
+// The match loop behind run_match_with() as a coroutine (MatchTask.h) that
+// suspends after every round, so one thread can interleave many matches.
+// robots, cfg and result must outlive the task, and robots must not be
+// shared with another live match since it holds the robot instances.
+// cfg.quiet is left to the caller: interleaved matches cannot each swap
+// cout in and out. Instantiated in Arena.cpp for HeadlessArena.
+template <class Policies>
+MatchTask match_rounds(std::vector<LoadedRobot>& robots, const ArenaConfig& cfg, MatchResult& result);
+
+// This thread's engine counters so far, which are reset to zero
+EngineCounters take_engine_counters();
+
+// Add counters taken on another thread or in a worker process to the
+// totals write_metrics() reports (it adds the calling thread's itself)
+void add_engine_counters(const EngineCounters& counters);
+
+// Write the engine counters (no-op unless built with ROBOTWARZ_METRICS)
+void write_metrics(const std::string& path, double elapsed_sec);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+class Board;
+
+// Policies that run_match_with<>() is built on. Each variant of the match
+// loop is compiled for the logging, rendering, randomness and timing it
+// needs, so a headless build has no output code in its loop at all rather
+// than a flag test on every log line.
+
+// Logger: the per-turn game log. Statements are written `log << a << b;`.
+// `enabled` lets the loop skip work that only feeds the log.
+struct StreamLogger {
+    static constexpr bool enabled = true;
+
+    template <class T>
+    StreamLogger& operator<<(const T& value) {
+        std::cout << value;
+        return *this;
+    }
+};
+
+struct NullLogger {
+    static constexpr bool enabled = false;
+
+    template <class T>
+    NullLogger& operator<<(const T&) { return *this; }
+};
+
+// Renderer: called with the board between rounds
+struct TerminalRenderer {
+    void end_round(const Board& board);     // print the board, wait for ENTER
+};
+
+struct NullRenderer {
+    void end_round(const Board&) {}
+};
+
+// Clock: fills ArenaConfig::phase_times. NullClock leaves it untouched and
+// never reads the time.
+struct SteadyClock {
+    static constexpr bool enabled = true;
+    using time_point = std::chrono::steady_clock::time_point;
+
+    static time_point now() { return std::chrono::steady_clock::now(); }
+    static double seconds_since(time_point start) {
+        return std::chrono::duration<double>(now() - start).count();
+    }
+};
+
+struct NullClock {
+    static constexpr bool enabled = false;
+};
+
+// Rng is the engine that places obstacles and robots, seeded with cfg.seed
+template <class LoggerT, class RendererT, class RngT, class ClockT>
+struct ArenaPolicies {
+    using Logger = LoggerT;
+    using Renderer = RendererT;
+    using Rng = RngT;
+    using Clock = ClockT;
+};
+
+// The variants run_match() chooses between
+using InteractiveArena = ArenaPolicies<StreamLogger, TerminalRenderer, std::mt19937, NullClock>;
+using LoggedArena = ArenaPolicies<StreamLogger, NullRenderer, std::mt19937, NullClock>;
+using HeadlessArena = ArenaPolicies<NullLogger, NullRenderer, std::mt19937, NullClock>;
+using ProfiledArena = ArenaPolicies<StreamLogger, NullRenderer, std::mt19937, SteadyClock>;
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "RobotBase.h"
+#include "Zobrist.h"
+
+// The arena grid. All writes go through set() so the Zobrist hash of the
+// board contents stays current without ever rescanning the grid. The same
+// choke point keeps the free-distance table used to resolve moves and feeds
+// an optional change journal for live spectators.
+//
+// Cells live in TILE x TILE tiles that are allocated the first time
+// something is written into them. A missing tile is all '.', unoccupied and
+// blocked only by the board edges, so memory grows with what is on the board
+// rather than with its area. The tile directory itself costs one pointer
+// per tile.
+class Board
+{
+public:
+    // Free distances are only ever compared with a move distance, and
+    // RobotBase caps move speed at 5, so they are stored capped.
+    static constexpr int REACH_CAP = 8;
+    static constexpr int TILE_SHIFT = 6;
+    static constexpr int TILE = 1 << TILE_SHIFT;
+
+private:
+    struct Tile {
+        char cells[TILE * TILE];
+        // reach[cell * 8 + dir - 1]: open cells in a straight line from cell
+        // towards directions[dir] before an edge or blocker, capped at REACH_CAP
+        uint8_t reach[TILE * TILE * 8];
+        char occupied[TILE * TILE];     // a live robot stands here
+        char dirty[TILE * TILE];        // written since take_changes()
+        int robots = 0;                 // occupied cells, so scans can skip the tile
+    };
+
+    int m_rows;
+    int m_cols;
+    int m_tile_cols;
+    std::vector<std::unique_ptr<Tile>> m_tiles;
+    unsigned long long m_hash = 0;
+    bool m_journal = false;
+    std::vector<long long> m_changed;   // cells written since take_changes()
+
+    Tile* tile(int r, int c) const {
+        return m_tiles[(size_t)(r >> TILE_SHIFT) * m_tile_cols + (c >> TILE_SHIFT)].get();
+    }
+    static int offset(int r, int c) { return (r & (TILE - 1)) * TILE + (c & (TILE - 1)); }
+
+    // Free distance when only the board edges block
+    int edge_reach(int r, int c, int dir) const {
+        int dr = directions[dir].first, dc = directions[dir].second;
+        int open = REACH_CAP;
+        if (dr < 0) open = std::min(open, r);
+        if (dr > 0) open = std::min(open, m_rows - 1 - r);
+        if (dc < 0) open = std::min(open, c);
+        if (dc > 0) open = std::min(open, m_cols - 1 - c);
+        return open;
+    }
+
+    // The tile holding (r, c), allocated and filled with empty cells if needed
+    Tile& materialize(int r, int c) {
+        std::unique_ptr<Tile>& slot = m_tiles[(size_t)(r >> TILE_SHIFT) * m_tile_cols + (c >> TILE_SHIFT)];
+        if (!slot) {
+            slot = std::make_unique<Tile>();
+            std::fill(std::begin(slot->cells), std::end(slot->cells), '.');
+            std::fill(std::begin(slot->reach), std::end(slot->reach), (uint8_t)REACH_CAP);
+            // only tiles near an edge see it
+            int r0 = r & ~(TILE - 1), c0 = c & ~(TILE - 1);
+            if (r0 < REACH_CAP || c0 < REACH_CAP || r0 + TILE + REACH_CAP > m_rows || c0 + TILE + REACH_CAP > m_cols) {
+                for (int tr = r0; tr < std::min(r0 + TILE, m_rows); ++tr)
+                    for (int tc = c0; tc < std::min(c0 + TILE, m_cols); ++tc)
+                        for (int dir = 1; dir <= 8; ++dir)
+                            slot->reach[offset(tr, tc) * 8 + dir - 1] = (uint8_t)edge_reach(tr, tc, dir);
+            }
+        }
+        return *slot;
+    }
+
+    // Walk back from a cell whose blocking changed, fixing the reach of the
+    // cells that look through it. Stops early once a value is unchanged, so
+    // one update touches at most 8 * REACH_CAP entries.
+    void update_reach(int r, int c) {
+        for (int dir = 1; dir <= 8; ++dir) {
+            int dr = directions[dir].first, dc = directions[dir].second;
+            int nr = r, nc = c;     // the cell the current one looks into
+            for (int k = 1; k <= REACH_CAP; ++k) {
+                int pr = nr - dr, pc = nc - dc;
+                if (!in_bounds(pr, pc)) break;
+                int open = blocked(nr, nc) ? 0 : std::min(REACH_CAP, 1 + reach(nr, nc, dir));
+                if (reach(pr, pc, dir) == open) break;
+                materialize(pr, pc).reach[offset(pr, pc) * 8 + dir - 1] = (uint8_t)open;
+                nr = pr;
+                nc = pc;
+            }
+        }
+    }
+
+public:
+    Board(int rows, int cols)
+        : m_rows(rows), m_cols(cols), m_tile_cols((cols + TILE - 1) / TILE),
+          m_tiles((size_t)((rows + TILE - 1) / TILE) * m_tile_cols) {}
+
+    // Robots cannot move onto or through mounds, wrecks ('X') or live
+    // robots. Live robots are tracked with set_occupied() rather than by
+    // their letter, since flames can be drawn over a robot that survives them.
+    static bool blocks_movement(char ch) { return ch == 'M' || ch == 'X'; }
+    bool blocked(int r, int c) const {
+        const Tile* t = tile(r, c);
+        return t && (blocks_movement(t->cells[offset(r, c)]) || t->occupied[offset(r, c)]);
+    }
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    bool in_bounds(int r, int c) const { return r >= 0 && r < m_rows && c >= 0 && c < m_cols; }
+
+    char at(int r, int c) const {
+        const Tile* t = tile(r, c);
+        return t ? t->cells[offset(r, c)] : '.';
+    }
+
+    void set(int r, int c, char ch) {
+        Tile* t = tile(r, c);
+        if (!t) {
+            if (ch == '.' && !m_journal) return;    // already empty
+            t = &materialize(r, c);
+        }
+        int o = offset(r, c);
+        char& cell = t->cells[o];
+        long long idx = (long long)r * m_cols + c;
+        m_hash ^= zobrist_cell_key(idx, cell) ^ zobrist_cell_key(idx, ch);
+        bool was_blocked = blocked(r, c);
+        cell = ch;
+        if (blocked(r, c) != was_blocked) update_reach(r, c);
+        if (m_journal && !t->dirty[o]) {
+            t->dirty[o] = 1;
+            m_changed.push_back(idx);
+        }
+    }
+
+    // Record that a live robot arrived at or left (r, c)
+    void set_occupied(int r, int c, bool occupied) {
+        Tile* t = tile(r, c);
+        if (!t) {
+            if (!occupied) return;
+            t = &materialize(r, c);
+        }
+        char& occ = t->occupied[offset(r, c)];
+        if ((bool)occ == occupied) return;
+        bool was_blocked = blocked(r, c);
+        occ = occupied;
+        t->robots += occupied ? 1 : -1;
+        if (blocked(r, c) != was_blocked) update_reach(r, c);
+    }
+
+    // Open cells from (r, c) towards directions[dir] (1..8), capped at
+    // REACH_CAP; a move of n steps is clear exactly when n <= reach()
+    int reach(int r, int c, int dir) const {
+        const Tile* t = tile(r, c);
+        return t ? t->reach[offset(r, c) * 8 + dir - 1] : edge_reach(r, c, dir);
+    }
+
+    // Call fn(r, c) for each occupied cell on the ray from (r, c) towards
+    // directions[dir] (1..8), nearest first, up to the edge. Tiles with no
+    // robots in them are crossed in a single step.
+    template <class Fn>
+    void for_each_occupied_on_ray(int r, int c, int dir, Fn fn) const {
+        int dr = directions[dir].first, dc = directions[dir].second;
+        r += dr;
+        c += dc;
+        while (in_bounds(r, c)) {
+            const Tile* t = tile(r, c);
+            if (!t || t->robots == 0) {
+                int steps = TILE;   // until the ray leaves this tile
+                if (dr > 0) steps = std::min(steps, TILE - (r & (TILE - 1)));
+                if (dr < 0) steps = std::min(steps, (r & (TILE - 1)) + 1);
+                if (dc > 0) steps = std::min(steps, TILE - (c & (TILE - 1)));
+                if (dc < 0) steps = std::min(steps, (c & (TILE - 1)) + 1);
+                r += dr * steps;
+                c += dc * steps;
+                continue;
+            }
+            if (t->occupied[offset(r, c)]) fn(r, c);
+            r += dr;
+            c += dc;
+        }
+    }
+
+    // Start listing written cells. The list is reserved here so set() does
+    // not allocate in a normal round; a round that writes more cells than
+    // that on a huge board just grows it once.
+    void enable_journal() {
+        m_journal = true;
+        m_changed.clear();
+        m_changed.reserve((size_t)std::min<long long>((long long)m_rows * m_cols, 1 << 16));
+    }
+
+    // Call fn(r, c, ch) once for every cell written since the last call
+    template <class Fn>
+    void take_changes(Fn fn) {
+        for (long long idx : m_changed) {
+            int r = (int)(idx / m_cols), c = (int)(idx % m_cols);
+            Tile* t = tile(r, c);
+            t->dirty[offset(r, c)] = 0;
+            fn(r, c, t->cells[offset(r, c)]);
+        }
+        m_changed.clear();
+    }
+
+    // Hash of the current contents; an empty board hashes to 0
+    unsigned long long hash() const { return m_hash; }
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "RadarObj.h"
+#include "RobotBase.h"
+
+// Robot call traces: everything one robot was shown during a match, so the
+// robot can be replayed on its own (see RobotReplay.cpp). Written by the
+// arena with --record-calls DIR, one DIR/<Robot_X>.calls file per robot.
+//
+// Layout, little endian, no padding:
+//   CallTraceHeader, then the robot source stem (name_len bytes)
+//   per turn: CallTurn, then radar_count CallRadarObj
+// State fields are what the robot's getters returned just before the
+// callback; the decision fields are what it answered.
+
+#pragma pack(push, 1)
+struct CallTraceHeader {
+    char magic[4];                  // "RWCT"
+    uint16_t version;
+    uint16_t name_len;
+    int32_t rows, cols;
+    uint32_t seed;
+    int32_t robot;                  // roster index, which seeds the robot's rand() stream
+};
+
+struct CallState {
+    int16_t row, col;
+    int16_t health, armor, grenades, move_speed;
+};
+
+struct CallTurn {
+    int32_t round;
+    CallState state;                // before get_radar_direction
+    CallState move_state;           // before get_move_direction
+    uint8_t asked_move;             // 0 when the turn ended before movement
+    int8_t radar_dir;
+    uint8_t shooting;
+    int16_t shot_r, shot_c;
+    int8_t move_dir, move_dist;
+    uint16_t radar_count;
+};
+
+struct CallRadarObj {
+    char type;
+    int16_t row, col;
+};
+#pragma pack(pop)
+
+static const uint16_t CALL_TRACE_VERSION = 2;
+
+// Helper: the robot-visible state the arena keeps in RobotBase
+inline CallState call_state(RobotBase* r) {
+    int row, col;
+    r->get_current_location(row, col);
+    return {(int16_t)row, (int16_t)col, (int16_t)r->get_health(), (int16_t)r->get_armor(),
+            (int16_t)r->get_grenades(), (int16_t)r->get_move_speed()};
+}
+
+// Helper: bring a replayed robot to a recorded state. Health, armor and
+// grenades only go down and movement is only ever disabled, so the same
+// RobotBase calls the arena makes get there.
+inline void apply_call_state(RobotBase* r, const CallState& s) {
+    r->move_to(s.row, s.col);
+    if (r->get_health() > s.health) r->take_damage(r->get_health() - s.health);
+    if (r->get_armor() > s.armor) r->reduce_armor(r->get_armor() - s.armor);
+    while (r->get_grenades() > s.grenades) r->decrement_grenades();
+    if (s.move_speed == 0 && r->get_move_speed() != 0) r->disable_movement();
+}
+
+class CallTraceWriter
+{
+private:
+    std::ofstream m_out;
+
+public:
+    bool open(const std::string& path, const std::string& name, int rows, int cols, unsigned seed,
+              int robot) {
+        m_out.open(path, std::ios::binary);
+        if (!m_out) return false;
+        CallTraceHeader h{{'R', 'W', 'C', 'T'}, CALL_TRACE_VERSION, (uint16_t)name.size(), rows, cols, seed,
+                          robot};
+        m_out.write((const char*)&h, sizeof h);
+        m_out.write(name.data(), name.size());
+        return true;
+    }
+
+    void write(const CallTurn& turn, const std::vector<RadarObj>& radar_results) {
+        CallTurn t = turn;
+        t.radar_count = (uint16_t)radar_results.size();
+        m_out.write((const char*)&t, sizeof t);
+        for (auto &o : radar_results) {
+            CallRadarObj c{o.m_type, (int16_t)o.m_row, (int16_t)o.m_col};
+            m_out.write((const char*)&c, sizeof c);
+        }
+    }
+};
+
+// A whole trace in memory, radar results expanded for process_radar_results
+struct CallTrace {
+    CallTraceHeader header;
+    std::string name;
+    std::vector<CallTurn> turns;
+    std::vector<std::vector<RadarObj>> radar;   // per turn
+
+    bool load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.read((char*)&header, sizeof header) || memcmp(header.magic, "RWCT", 4) != 0
+            || header.version != CALL_TRACE_VERSION) return false;
+        name.resize(header.name_len);
+        if (!in.read(name.data(), name.size())) return false;
+        CallTurn t;
+        while (in.read((char*)&t, sizeof t)) {
+            std::vector<RadarObj> objs(t.radar_count);
+            for (auto &o : objs) {
+                CallRadarObj c;
+                if (!in.read((char*)&c, sizeof c)) return false;
+                o = RadarObj(c.type, c.row, c.col);
+            }
+            turns.push_back(t);
+            radar.push_back(std::move(objs));
+        }
+        return in.eof() && in.gcount() == 0;   // no half-written turn at the end
+    }
+};
@@ -0,0 +1,64 @@
+// Spatial heatmaps: per-cell counters shared across batch workers
+#include <bits/stdc++.h>
+#include <sys/mman.h>
+#include "Heatmap.h"
+
+using namespace std;
+
+Heatmap::~Heatmap() {
+    if (m_counts) munmap(m_counts, m_bytes);
+}
+
+bool Heatmap::create(int rows, int cols) {
+    if (rows <= 0 || cols <= 0) {
+        cerr << "Heatmap needs a board, not " << rows << "x" << cols << "\n";
+        return false;
+    }
+    m_bytes = ((size_t)HEAT_LAYERS * rows * cols + 1) * sizeof(uint64_t);
+    void* mem = mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        cerr << "mmap of heatmap counters failed: " << strerror(errno) << "\n";
+        return false;
+    }
+    m_counts = (uint64_t*)mem;
+    m_rows = rows;
+    m_cols = cols;
+    return true;
+}
+
+bool Heatmap::write(const string& path) const {
+    bool csv = filesystem::path(path).extension() == ".csv";
+    ofstream out(path, csv ? ios::out : ios::out | ios::binary);
+    if (!out) {
+        cerr << "Could not write heatmap " << path << "\n";
+        return false;
+    }
+    size_t cells = (size_t)m_rows * m_cols;
+    if (csv) {
+        out << "row,col,occupancy,damage,deaths,flame_hits,pit_traps\n";
+        for (size_t cell = 0; cell < cells; ++cell) {
+            bool any = false;
+            for (int layer = 0; layer < HEAT_LAYERS; ++layer) any |= m_counts[layer * cells + cell] != 0;
+            if (!any) continue;
+            out << cell / m_cols << "," << cell % m_cols;
+            for (int layer = 0; layer < HEAT_LAYERS; ++layer) out << "," << m_counts[layer * cells + cell];
+            out << "\n";
+        }
+    } else {
+        HeatmapHeader h{};
+        memcpy(h.magic, "RWHM", 4);
+        h.version = HEATMAP_VERSION;
+        h.layers = HEAT_LAYERS;
+        h.rows = m_rows;
+        h.cols = m_cols;
+        h.games = games();
+        out.write((const char*)&h, sizeof h);
+        out.write((const char*)m_counts, (streamsize)(HEAT_LAYERS * cells * sizeof(uint64_t)));
+    }
+    out.flush();
+    if (!out) {
+        cerr << "Could not write heatmap " << path << "\n";
+        return false;
+    }
+    return true;
+}
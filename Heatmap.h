@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Per-cell counters summed over every match played with
+// ArenaConfig::heatmap set (--heatmap FILE). The match loop bumps a counter
+// where the event already happens: occupancy for each live robot at the end
+// of every round, damage where health is lost, a death where a robot is
+// found dead, flame hits and pit traps where a move lands on one. Nothing is
+// written until the run ends, so a batch of thousands of games costs a few
+// adds per event instead of a game log to parse afterwards.
+//
+// The counters live in a shared anonymous mapping and are bumped with
+// relaxed atomic adds, so forked batch workers, interleaved threads and
+// plain matches all count into the same grid with no merge step.
+//
+// File formats, picked by extension:
+//   .csv    row,col,occupancy,damage,deaths,flame_hits,pit_traps for every
+//           cell with a nonzero counter
+//   other   HeatmapHeader, then HEAT_LAYERS planes of rows * cols uint64_t
+//           in HeatLayer order, row-major, little endian, no padding
+
+enum HeatLayer {
+    HEAT_OCCUPANCY,                 // robot-rounds spent on the cell
+    HEAT_DAMAGE,                    // health lost there, shots and flames
+    HEAT_DEATHS,                    // robots that died or were disqualified there
+    HEAT_FLAME_HITS,                // moves that landed in flames
+    HEAT_PIT_TRAPS,                 // moves that landed in a pit
+    HEAT_LAYERS
+};
+
+#pragma pack(push, 1)
+struct HeatmapHeader {
+    char magic[4];                  // "RWHM"
+    uint16_t version;
+    uint16_t layers;                // HEAT_LAYERS
+    int32_t rows, cols;
+    uint64_t games;
+};
+#pragma pack(pop)
+
+static const uint16_t HEATMAP_VERSION = 1;
+
+class Heatmap
+{
+private:
+    uint64_t* m_counts = nullptr;   // HEAT_LAYERS planes, then the game count
+    size_t m_bytes = 0;
+    int m_rows = 0;
+    int m_cols = 0;
+
+public:
+    Heatmap() = default;
+    ~Heatmap();
+    Heatmap(const Heatmap&) = delete;
+    Heatmap& operator=(const Heatmap&) = delete;
+
+    // Map zeroed counters for a rows x cols board, shared with any child
+    // forked afterwards
+    bool create(int rows, int cols);
+
+    bool fits(int rows, int cols) const { return rows == m_rows && cols == m_cols; }
+
+    void add(HeatLayer layer, int row, int col, uint64_t n = 1) {
+        size_t cell = (size_t)layer * m_rows * m_cols + (size_t)row * m_cols + col;
+        std::atomic_ref<uint64_t>(m_counts[cell]).fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void add_game() {
+        std::atomic_ref<uint64_t>(m_counts[(size_t)HEAT_LAYERS * m_rows * m_cols])
+            .fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t games() const { return m_counts[(size_t)HEAT_LAYERS * m_rows * m_cols]; }
+
+    // Write the grid as CSV or binary, by path's extension (see above)
+    bool write(const std::string& path) const;
+};
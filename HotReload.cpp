@@ -0,0 +1,181 @@
+// inotify-driven robot rebuilds for long batch runs
+#include <bits/stdc++.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "HotReload.h"
+
+using namespace std;
+
+// Editors often write a file in several steps; wait for this long without
+// events before compiling what changed.
+static const int SETTLE_MS = 200;
+
+static bool is_robot_source(const string& name) {
+    return name.rfind("Robot_", 0) == 0 && name.size() > 10
+        && name.compare(name.size() - 4, 4, ".cpp") == 0;
+}
+
+// Helper: one spelling per file, so "./Robot_A.cpp" matches "Robot_A.cpp"
+static string normal_path(const string& path) {
+    return filesystem::path(path).lexically_normal().string();
+}
+
+RobotWatcher::~RobotWatcher() {
+    stop();
+}
+
+bool RobotWatcher::start(const vector<LoadedRobot>& robots, const vector<string>& entrant_dirs) {
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        cerr << "inotify_init1 failed: " << strerror(errno) << "\n";
+        return false;
+    }
+    // IN_MOVED_TO catches editors that save by renaming a temp file
+    auto watch_dir = [&](const string& dir, bool entrants) {
+        int wd = inotify_add_watch(m_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            cerr << "inotify_add_watch failed for " << dir << ": " << strerror(errno) << "\n";
+            return false;
+        }
+        // the same directory spelled twice shares one watch
+        auto [it, added] = m_dirs.emplace(wd, WatchedDir{dir, entrants});
+        it->second.entrants |= entrants;
+        return true;
+    };
+    bool ok = true;
+    for (auto &dir : entrant_dirs) ok = ok && watch_dir(dir, true);
+    for (auto &lr : robots) {
+        string dir = filesystem::path(lr.cpp_file).parent_path().string();
+        ok = ok && watch_dir(dir.empty() ? "." : dir, false);
+        m_sources.insert(normal_path(lr.cpp_file));
+    }
+    if (!ok) {
+        close(m_fd);
+        m_fd = -1;
+        m_dirs.clear();
+        m_sources.clear();
+        return false;
+    }
+    m_thread = thread(&RobotWatcher::watch_loop, this);
+    cout << "Watching robot sources for changes.\n";
+    return true;
+}
+
+void RobotWatcher::stop() {
+    m_stop = true;
+    if (m_thread.joinable()) m_thread.join();
+    if (m_fd >= 0) close(m_fd);
+    m_fd = -1;
+
+    // builds that never made it into a match
+    for (auto &b : m_ready) unlink(b.so_file.c_str());
+    m_ready.clear();
+}
+
+void RobotWatcher::watch_loop() {
+    set<string> changed;
+    alignas(inotify_event) char buf[4096];
+
+    while (!m_stop) {
+        pollfd pfd{m_fd, POLLIN, 0};
+        int n = poll(&pfd, 1, SETTLE_MS);
+        if (n < 0 && errno != EINTR) break;
+
+        if (n == 0) {
+            // quiet for SETTLE_MS: build whatever changed
+            if (!changed.empty()) {
+                rebuild(changed);
+                changed.clear();
+            }
+            continue;
+        }
+
+        ssize_t len;
+        while ((len = read(m_fd, buf, sizeof buf)) > 0) {
+            for (char* p = buf; p < buf + len;) {
+                auto* ev = reinterpret_cast<inotify_event*>(p);
+                auto dir = m_dirs.find(ev->wd);
+                if (ev->len > 0 && dir != m_dirs.end() && is_robot_source(ev->name)) {
+                    const WatchedDir& d = dir->second;
+                    string cpp = d.path == "." ? string(ev->name) : (filesystem::path(d.path) / ev->name).string();
+                    if (d.entrants || m_sources.count(normal_path(cpp))) changed.insert(cpp);
+                }
+                p += sizeof(inotify_event) + ev->len;
+            }
+        }
+    }
+}
+
+void RobotWatcher::rebuild(const set<string>& changed) {
+    for (auto &cpp : changed) {
+        // dlopen caches libraries by path, so every rebuild gets its own file
+        Build b;
+        b.cpp_file = cpp;
+        if (!compile_robot(cpp, b.so_file, ".r" + to_string(++m_generation))) {
+            cerr << "Rebuild of " << cpp << " failed - keeping the loaded version\n";
+            continue;
+        }
+
+        lock_guard<mutex> lock(m_mutex);
+        // a newer build of the same robot replaces one still waiting
+        for (auto it = m_ready.begin(); it != m_ready.end(); ++it) {
+            if (it->cpp_file == cpp) {
+                unlink(it->so_file.c_str());
+                m_ready.erase(it);
+                break;
+            }
+        }
+        m_ready.push_back(b);
+        m_ready_cv.notify_all();
+    }
+}
+
+vector<string> RobotWatcher::apply(vector<LoadedRobot>& robots, bool add_new) {
+    vector<Build> ready;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        ready.swap(m_ready);
+    }
+
+    vector<string> reloaded;
+    for (auto &b : ready) {
+        string source = normal_path(b.cpp_file);
+        auto it = find_if(robots.begin(), robots.end(),
+                          [&](const LoadedRobot& lr) { return normal_path(lr.cpp_file) == source; });
+        if (it == robots.end() && !add_new) {
+            cout << "Hot reload: not adding " << b.cpp_file << " to a running batch\n";
+            unlink(b.so_file.c_str());
+            continue;
+        }
+
+        LoadedRobot fresh;
+        fresh.cpp_file = it == robots.end() ? b.cpp_file : it->cpp_file;
+        fresh.so_file = b.so_file;
+        if (!open_robot(fresh)) {
+            unlink(b.so_file.c_str());
+            continue;
+        }
+
+        if (it == robots.end()) {
+            cout << "Hot reload: added " << fresh.cpp_file << "\n";
+            robots.push_back(fresh);
+        } else {
+            // between matches there are no instances left, so the old
+            // library can go right away; the startup build stays
+            string old_so = it->so_file;
+            string base = filesystem::path(b.cpp_file).stem().string();
+            unload_robot(*it);
+            if (old_so != "./lib" + base + ".so") unlink(old_so.c_str());
+            *it = fresh;
+            cout << "Hot reload: swapped in new " << fresh.cpp_file << "\n";
+        }
+        reloaded.push_back(fresh.cpp_file);
+    }
+    return reloaded;
+}
+
+void RobotWatcher::wait_for_build() {
+    unique_lock<mutex> lock(m_mutex);
+    m_ready_cv.wait(lock, [&] { return !m_ready.empty(); });
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Arena.h"
+
+// Watches the directory of every loaded robot for changes to its source with
+// inotify and rebuilds changed robots on a background thread. Robots new to
+// a directory are only picked up from the directories the roster was
+// discovered in (--robots DIR, or the current directory); a robot named by
+// file brings only itself. Finished builds are only
+// swapped into the roster when apply() is called, which the ladder and the
+// forked batch runner do between matches, so a match in progress never sees
+// a robot change.
+class RobotWatcher
+{
+private:
+    struct Build {
+        std::string cpp_file;
+        std::string so_file;
+    };
+
+    struct WatchedDir {
+        std::string path;               // as robot paths spell it, "." for the current directory
+        bool entrants = false;          // new robots may join from here
+    };
+
+    int m_fd = -1;
+    std::map<int, WatchedDir> m_dirs;   // by inotify watch descriptor
+    std::set<std::string> m_sources;    // the roster's sources, lexically normal
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    std::mutex m_mutex;
+    std::condition_variable m_ready_cv;
+    std::vector<Build> m_ready;         // compiled, waiting for a match boundary
+    int m_generation = 0;
+
+    void watch_loop();
+    void rebuild(const std::set<std::string>& changed);
+
+public:
+    ~RobotWatcher();
+
+    // Start watching the sources of robots, plus new robots in entrant_dirs;
+    // false if inotify is unavailable
+    bool start(const std::vector<LoadedRobot>& robots, const std::vector<std::string>& entrant_dirs);
+    void stop();
+
+    // Swap finished builds into robots (no match in this process may be
+    // running). Changed robots are opened afresh with open_robot(); robots
+    // new to an entrant directory are appended when add_new is set and
+    // dropped otherwise. Returns the cpp files that were (re)loaded, spelled
+    // as in robots.
+    std::vector<std::string> apply(std::vector<LoadedRobot>& robots, bool add_new = true);
+
+    // block until at least one rebuilt robot is ready to apply
+    void wait_for_build();
+};
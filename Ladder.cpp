@@ -0,0 +1,192 @@
+// Rating ladder: Glicko ratings kept in a local file plus a scheduler that
+// plays whichever duel tells us the most about the current ratings.
+#include <bits/stdc++.h>
+#include "Ladder.h"
+#include "ResultCache.h"
+
+using namespace std;
+
+static const double GLICKO_Q = log(10.0) / 400.0;
+static const double MIN_RD = 30.0;     // keep ratings able to move a little
+
+// Glicko attenuation for an opponent with uncertainty rd
+static double glicko_g(double rd) {
+    return 1.0 / sqrt(1.0 + 3.0 * GLICKO_Q * GLICKO_Q * rd * rd / (M_PI * M_PI));
+}
+
+// Expected score of a against b
+static double expected_score(const Rating& a, const Rating& b) {
+    return 1.0 / (1.0 + pow(10.0, -glicko_g(b.rd) * (a.rating - b.rating) / 400.0));
+}
+
+// Helper: robot name used as the ladder key
+static string ladder_name(const LoadedRobot& lr) {
+    return lr.cpp_file.substr(0, lr.cpp_file.find(".cpp"));
+}
+
+bool load_ratings(const string& path, RatingTable& table) {
+    ifstream in(path);
+    if (!in) return true; // first run, nothing stored yet
+
+    string line;
+    int line_no = 0;
+    while (getline(in, line)) {
+        line_no++;
+        if (line.empty() || line[0] == '#') continue;
+        istringstream fields(line);
+        string name;
+        Rating r;
+        if (!(fields >> name >> r.rating >> r.rd >> r.games)) {
+            cerr << path << ":" << line_no << ": bad ladder entry\n";
+            return false;
+        }
+        table[name] = r;
+    }
+    return true;
+}
+
+bool save_ratings(const string& path, const RatingTable& table) {
+    string tmp = path + ".tmp";
+    {
+        ofstream out(tmp);
+        if (!out) {
+            cerr << "Could not write ladder file " << tmp << "\n";
+            return false;
+        }
+        out << "# RobotWarz ladder: name rating rd games\n";
+        out << fixed << setprecision(1);
+        for (auto &[name, r] : table)
+            out << name << " " << r.rating << " " << r.rd << " " << r.games << "\n";
+    }
+    // rename so an interrupted run never leaves a half-written ladder
+    return rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+void update_ratings(RatingTable& table, const vector<string>& names, const MatchResult& result) {
+    // Every participant is rated against the others' pre-match ratings
+    vector<Rating> before;
+    for (auto &n : names) before.push_back(table[n]);
+
+    for (size_t i = 0; i < names.size(); ++i) {
+        double inv_d2 = 0.0;
+        double delta = 0.0;
+        for (size_t j = 0; j < names.size(); ++j) {
+            if (i == j) continue;
+            double score = 0.5;
+            if (result.place[i] < result.place[j]) score = 1.0;
+            else if (result.place[i] > result.place[j]) score = 0.0;
+
+            double g = glicko_g(before[j].rd);
+            double e = expected_score(before[i], before[j]);
+            inv_d2 += GLICKO_Q * GLICKO_Q * g * g * e * (1.0 - e);
+            delta += g * (score - e);
+        }
+
+        double var = 1.0 / (1.0 / (before[i].rd * before[i].rd) + inv_d2);
+        Rating& r = table[names[i]];
+        r.rating = before[i].rating + GLICKO_Q * var * delta;
+        r.rd = max(MIN_RD, sqrt(var));
+        r.games++;
+    }
+}
+
+double matchup_information(const Rating& a, const Rating& b) {
+    auto variance_drop = [](const Rating& self, const Rating& opp) {
+        double g = glicko_g(opp.rd);
+        double e = expected_score(self, opp);
+        double var = self.rd * self.rd;
+        return var - 1.0 / (1.0 / var + GLICKO_Q * GLICKO_Q * g * g * e * (1.0 - e));
+    };
+    return variance_drop(a, b) + variance_drop(b, a);
+}
+
+bool run_ladder(vector<LoadedRobot>& robots, const ArenaConfig& cfg,
+                int max_games, double stable_rd, const string& path,
+                RobotWatcher* watcher) {
+    if (robots.size() < 2) {
+        cerr << "Ladder needs at least two robots.\n";
+        return false;
+    }
+
+    RatingTable table;
+    if (!load_ratings(path, table)) return false;
+
+    vector<string> names;
+    for (auto &lr : robots) {
+        names.push_back(ladder_name(lr));
+        table.emplace(names.back(), Rating());
+    }
+
+    // Between matches: pick up rebuilt robots. A changed robot keeps its
+    // rating as a starting point but is as uncertain as a new one.
+    auto reload = [&]() {
+        if (!watcher) return;
+        for (auto &cpp : watcher->apply(robots)) {
+            string name = cpp.substr(0, cpp.find(".cpp"));
+            if (find(names.begin(), names.end(), name) == names.end()) names.push_back(name);
+            table[name].rd = Rating().rd;
+        }
+    };
+
+    int played = 0;
+    for (; played < max_games; ++played) {
+        reload();
+
+        // Most informative pair; stop once nobody is uncertain any more
+        double best_info = -1.0;
+        size_t a = 0, b = 1;
+        bool stable = true;
+        for (size_t i = 0; i < robots.size(); ++i) {
+            if (table[names[i]].rd >= stable_rd) stable = false;
+            for (size_t j = i + 1; j < robots.size(); ++j) {
+                double info = matchup_information(table[names[i]], table[names[j]]);
+                if (info > best_info) {
+                    best_info = info;
+                    a = i;
+                    b = j;
+                }
+            }
+        }
+        if (stable && watcher) {
+            cout << "Ladder is stable; waiting for a robot to change...\n";
+            watcher->wait_for_build();
+            --played;
+            continue;
+        }
+        if (stable) break;
+
+        vector<LoadedRobot> duel = {robots[a], robots[b]};
+        ArenaConfig match_cfg = cfg;
+        match_cfg.seed = cfg.seed + (unsigned)played;
+        match_cfg.layout_index = (unsigned long long)played;
+        MatchResult result;
+        unsigned long long key = cfg.cache ? cfg.cache->key(duel, match_cfg) : 0;
+        bool cached = key && cfg.cache->lookup(key, result);
+        if (!cached) {
+            if (!run_match(duel, match_cfg, result)) return false;
+            if (key && !cfg.cache->store(key, result)) return false;
+        }
+
+        update_ratings(table, {names[a], names[b]}, result);
+        if (!save_ratings(path, table)) return false;
+
+        cout << "Ladder game " << played + 1 << ": " << names[a] << " vs " << names[b] << " -> "
+             << (result.winner < 0 ? string("draw") : names[result.winner == 0 ? a : b])
+             << " after " << result.rounds << " rounds" << (cached ? " (cached)" : "") << "\n";
+    }
+
+    // Final standings, best first
+    vector<pair<string, Rating>> standings(table.begin(), table.end());
+    sort(standings.begin(), standings.end(),
+         [](const auto& x, const auto& y) { return x.second.rating > y.second.rating; });
+
+    cout << "\nLadder after " << played << " games (" << path << "):\n";
+    cout << fixed << setprecision(1);
+    for (auto &[name, r] : standings) {
+        cout << setw(20) << left << name << right
+             << setw(8) << r.rating << " +/- " << setw(5) << r.rd
+             << "  games: " << r.games << "\n";
+    }
+    cout.unsetf(ios::fixed);
+    return true;
+}
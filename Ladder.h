@@ -0,0 +1,41 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Arena.h"
+#include "HotReload.h"
+
+// Glicko-style rating: rd is the uncertainty (one standard deviation).
+// New robots start at 1500 +/- 350 and settle as they play.
+struct Rating {
+    double rating = 1500.0;
+    double rd = 350.0;
+    int games = 0;
+};
+
+// Ratings keyed by robot source file without ".cpp" (e.g. "Robot_Teto")
+typedef std::map<std::string, Rating> RatingTable;
+
+// Read/write the compact ladder file: one "name rating rd games" line per robot.
+// A missing file loads as an empty table.
+bool load_ratings(const std::string& path, RatingTable& table);
+bool save_ratings(const std::string& path, const RatingTable& table);
+
+// Update every participant from the pairwise outcomes implied by result.place
+void update_ratings(RatingTable& table, const std::vector<std::string>& names, const MatchResult& result);
+
+// Expected drop in total rating variance if a and b play a duel
+double matchup_information(const Rating& a, const Rating& b);
+
+// Play up to max_games duels, each time picking the pair whose result would
+// shrink rating uncertainty the most, and stop early once every robot's rd
+// is below stable_rd. Ratings are saved after every match. With a watcher,
+// edited robots are swapped in between matches and their uncertainty is
+// reset, and a stable ladder waits for the next edit instead of stopping.
+// Duels found in cfg.cache are scored without being played. Game N starts
+// from layout N when cfg.layouts is set.
+bool run_ladder(std::vector<LoadedRobot>& robots, const ArenaConfig& cfg,
+                int max_games, double stable_rd, const std::string& path,
+                RobotWatcher* watcher = nullptr);
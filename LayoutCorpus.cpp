@@ -0,0 +1,84 @@
+// Starting-layout corpus: a read-only mapping indexed by game number
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "LayoutCorpus.h"
+
+using namespace std;
+
+LayoutCorpus::~LayoutCorpus() {
+    if (m_mem) munmap(m_mem, m_bytes);
+}
+
+bool LayoutCorpus::open(const string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Cannot open layout corpus " << path << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(LayoutCorpusHeader)) {
+        cerr << path << " is not a layout corpus\n";
+        close(fd);
+        return false;
+    }
+    m_bytes = (size_t)st.st_size;
+    void* mem = mmap(nullptr, m_bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        cerr << "mmap of layout corpus " << path << " failed: " << strerror(errno) << "\n";
+        return false;
+    }
+    m_mem = mem;
+    m_header = (const LayoutCorpusHeader*)m_mem;
+
+    const LayoutCorpusHeader& h = *m_header;
+    if (memcmp(h.magic, "RWLC", 4) != 0 || h.version != LAYOUT_CORPUS_VERSION) {
+        cerr << path << " is not a version " << LAYOUT_CORPUS_VERSION << " layout corpus\n";
+        return false;
+    }
+    long long record = (long long)h.flames + h.pits + h.mounds + h.robots;
+    if (h.rows <= 0 || h.cols <= 0 || h.flames < 0 || h.pits < 0 || h.mounds < 0 || h.robots < 1
+        || record != h.record_cells
+        || m_bytes != sizeof(LayoutCorpusHeader) + h.count * h.record_cells * sizeof(uint64_t)) {
+        cerr << path << " is truncated or has a bad header\n";
+        return false;
+    }
+    return true;
+}
+
+void LayoutCorpus::apply_board(ArenaConfig& cfg) const {
+    cfg.rows = m_header->rows;
+    cfg.cols = m_header->cols;
+    cfg.num_flames = m_header->flames;
+    cfg.num_pits = m_header->pits;
+    cfg.num_mounds = m_header->mounds;
+}
+
+const uint64_t* LayoutCorpus::layout_for(const ArenaConfig& cfg, size_t robots) const {
+    const LayoutCorpusHeader& h = *m_header;
+    if (cfg.layout_index >= h.count) {
+        cerr << "Layout " << cfg.layout_index << " is past the end of the corpus (" << h.count << " layouts)\n";
+        return nullptr;
+    }
+    if (cfg.rows != h.rows || cfg.cols != h.cols || cfg.num_flames != h.flames || cfg.num_pits != h.pits
+        || cfg.num_mounds != h.mounds) {
+        cerr << "The layout corpus is for a different board\n";
+        return nullptr;
+    }
+    if (robots > (size_t)h.robots) {
+        cerr << "The layout corpus has spawns for " << h.robots << " robots, not " << robots << "\n";
+        return nullptr;
+    }
+    const uint64_t* cells = (const uint64_t*)(m_header + 1) + cfg.layout_index * h.record_cells;
+    uint64_t board_cells = (uint64_t)h.rows * h.cols;
+    for (uint32_t k = 0; k < h.record_cells; ++k) {
+        if (cells[k] >= board_cells) {
+            cerr << "Layout " << cfg.layout_index << " has a cell off the board\n";
+            return nullptr;
+        }
+    }
+    return cells;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Arena.h"
+
+// Starting-layout corpus: obstacle and spawn cells for many games on one
+// board config, generated once (RobotWarzArena --write-layouts) and
+// memory-mapped by every arena that plays on it (--layouts). Game N of a
+// batch or ladder starts from layout N, so two versions of a robot can be
+// compared on exactly the same boards.
+//
+// Layout, little endian, no padding:
+//   LayoutCorpusHeader, then `count` records of `record_cells` uint64_t
+// A record holds cell indices (row * cols + col): the flames, then the pits,
+// then the mounds, then one spawn cell per roster slot. Layout k holds the
+// cells that seed `seed + k` would draw in a live match, and the writer
+// checks that every cell is on the board and used once.
+
+#pragma pack(push, 1)
+struct LayoutCorpusHeader {
+    char magic[4];                  // "RWLC"
+    uint16_t version;
+    uint16_t reserved;
+    int32_t rows, cols;
+    int32_t flames, pits, mounds;
+    int32_t robots;                 // spawn cells per layout
+    uint32_t seed;
+    uint32_t record_cells;          // flames + pits + mounds + robots
+    uint64_t count;
+};
+#pragma pack(pop)
+
+static const uint16_t LAYOUT_CORPUS_VERSION = 1;
+
+class LayoutCorpus
+{
+private:
+    void* m_mem = nullptr;
+    size_t m_bytes = 0;
+    const LayoutCorpusHeader* m_header = nullptr;
+
+public:
+    LayoutCorpus() = default;
+    ~LayoutCorpus();
+    LayoutCorpus(const LayoutCorpus&) = delete;
+    LayoutCorpus& operator=(const LayoutCorpus&) = delete;
+
+    // Map a corpus file read-only and check its header and size
+    bool open(const std::string& path);
+
+    const LayoutCorpusHeader& header() const { return *m_header; }
+
+    // Copy the corpus's board size and obstacle counts into cfg
+    void apply_board(ArenaConfig& cfg) const;
+
+    // Record for cfg.layout_index, or null (with a message) if the index is
+    // past the end, cfg's board differs from the corpus's, the roster has
+    // more robots than the corpus has spawns, or a cell is off the board
+    const uint64_t* layout_for(const ArenaConfig& cfg, size_t robots) const;
+};
+
+// Draw `count` layouts for cfg's board and `robots` spawns with seeds
+// cfg.seed, cfg.seed + 1, ..., exactly as live matches place them, and
+// write them to path. Defined in Arena.cpp next to the live placement.
+bool write_layout_corpus(const std::string& path, const ArenaConfig& cfg, int robots, uint64_t count);
@@ -0,0 +1,138 @@
+// Loadout sweep: every legal move/armor/weapon build of one robot, ranked by wins
+#include <bits/stdc++.h>
+#include <unistd.h>
+#include "Loadout.h"
+#include "MatchServer.h"
+
+using namespace std;
+
+static const char* LOADOUT_DIR = "loadout";
+static const char* WEAPON_TOKENS[] = {"flamethrower", "railgun", "grenade", "hammer"};
+
+struct Variant {
+    int move;
+    int armor;
+    int weapon;                     // WeaponType
+    LoadedRobot robot;
+    bool built = false;
+    BatchSummary summary;
+};
+
+// Helper: the loadout RobotBase's constructor actually gives for these
+// arguments (move clamped to 2-5, armor to 0 .. 7 - move); -1 weapon if unknown
+void clamp_loadout(const string& move_arg, const string& armor_arg, const string& weapon_arg,
+                   int& move, int& armor, int& weapon) {
+    move = armor = weapon = -1;
+    try {
+        move = clamp(stoi(move_arg), 2, 5);
+        armor = clamp(stoi(armor_arg), 0, 7 - move);
+    } catch (const exception&) {
+        move = armor = -1;
+    }
+    for (int w = 0; w < 4; ++w) {
+        if (weapon_arg == WEAPON_TOKENS[w]) weapon = w;
+    }
+}
+
+bool run_loadout_sweep(const string& cpp_file, vector<LoadedRobot>& opponents,
+                       const ArenaConfig& cfg, int matches, int jobs) {
+    ifstream in(cpp_file);
+    if (!in) {
+        cerr << "Cannot read " << cpp_file << "\n";
+        return false;
+    }
+    string source((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    static const regex ctor(R"(RobotBase\s*\(\s*([^,()]+?)\s*,\s*([^,()]+?)\s*,\s*([^,()]+?)\s*\))");
+    smatch m;
+    if (!regex_search(source, m, ctor)) {
+        cerr << "No RobotBase(move, armor, weapon) call found in " << cpp_file << "\n";
+        return false;
+    }
+    int cur_move, cur_armor, cur_weapon;
+    clamp_loadout(m[1], m[2], m[3], cur_move, cur_armor, cur_weapon);
+    string before = source.substr(0, m.position(0));
+    string after = source.substr(m.position(0) + m.length(0));
+
+    // Write every legal variant
+    error_code ec;
+    filesystem::create_directories(LOADOUT_DIR, ec);
+    string stem = filesystem::path(cpp_file).stem().string();
+    vector<Variant> variants;
+    for (int move = 2; move <= 5; ++move) {
+        for (int armor = 0; armor <= 7 - move; ++armor) {
+            for (int weapon = 0; weapon < 4; ++weapon) {
+                Variant v{move, armor, weapon, {}, false, {}};
+                v.robot.cpp_file = (filesystem::path(LOADOUT_DIR) / (stem + "_m" + to_string(move) + "a"
+                                    + to_string(armor) + "_" + WEAPON_TOKENS[weapon] + ".cpp")).string();
+                ofstream out(v.robot.cpp_file);
+                out << before << "RobotBase(" << move << ", " << armor << ", " << WEAPON_TOKENS[weapon] << ")" << after;
+                if (!out) {
+                    cerr << "Cannot write " << v.robot.cpp_file << "\n";
+                    return false;
+                }
+                variants.push_back(v);
+            }
+        }
+    }
+
+    // Compile them `jobs` at a time; each compile is its own g++ process
+    cout << "Building " << variants.size() << " loadouts of " << cpp_file << " with " << jobs << " jobs...\n";
+    atomic<size_t> next{0};
+    vector<thread> builders;
+    for (int j = 0; j < jobs; ++j) {
+        builders.emplace_back([&] {
+            for (size_t i; (i = next.fetch_add(1)) < variants.size();)
+                variants[i].built = compile_robot(variants[i].robot.cpp_file, variants[i].robot.so_file);
+        });
+    }
+    for (auto &t : builders) t.join();
+
+    // Same seeds and opponents for every variant
+    bool ok = true;
+    int played = 0;
+    for (auto &v : variants) {
+        if (!v.built || !open_robot(v.robot)) {
+            cerr << "Skipping " << v.robot.cpp_file << ": build failed\n";
+            continue;
+        }
+        vector<LoadedRobot> roster{v.robot};
+        roster.insert(roster.end(), opponents.begin(), opponents.end());
+        ok = run_batch(roster, cfg, matches, jobs, v.summary, false) && ok;
+        cout << "  move " << v.move << " armor " << v.armor << " " << setw(12) << left << WEAPON_TOKENS[v.weapon]
+             << right << " wins " << v.summary.wins[0] << "/" << v.summary.played << "\n";
+        played++;
+    }
+
+    stable_sort(variants.begin(), variants.end(), [](const Variant& a, const Variant& b) {
+        if (a.summary.played == 0 || b.summary.played == 0) return a.summary.played > b.summary.played;
+        double wa = (double)a.summary.wins[0] / a.summary.played, wb = (double)b.summary.wins[0] / b.summary.played;
+        if (wa != wb) return wa > wb;
+        return a.summary.draws * b.summary.played > b.summary.draws * a.summary.played;
+    });
+
+    cout << "\nLoadouts of " << cpp_file << " by win rate (" << matches << " matches each against "
+         << opponents.size() << " opponents, seeds from " << cfg.seed << "):\n";
+    cout << "rank  move  armor  weapon         wins    win %  draws\n";
+    int rank = 0;
+    for (auto &v : variants) {
+        if (v.summary.played == 0) continue;
+        cout << setw(4) << ++rank << setw(6) << v.move << setw(7) << v.armor << "  " << setw(13) << left
+             << WEAPON_TOKENS[v.weapon] << right << setw(6) << v.summary.wins[0] << setw(9) << fixed
+             << setprecision(1) << 100.0 * v.summary.wins[0] / v.summary.played << setw(7) << v.summary.draws;
+        cout.unsetf(ios::fixed);
+        if (v.move == cur_move && v.armor == cur_armor && v.weapon == cur_weapon) cout << "  <- current";
+        cout << "\n";
+    }
+    if (played == 0) {
+        cerr << "No loadout could be built.\n";
+        ok = false;
+    }
+
+    for (auto &v : variants) {
+        unload_robot(v.robot);
+        if (v.built) unlink(v.robot.so_file.c_str());
+    }
+    cout << "Variant sources are in " << LOADOUT_DIR << "/\n";
+    return ok;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Arena.h"
+
+// Loadout sweep: rebuild one robot with every legal (move, armor, weapon)
+// combination and rank the variants by how often they win.
+//
+// The first RobotBase(move, armor, weapon) call in cpp_file is rewritten
+// for each of the 72 legal loadouts (move 2-5, armor 0 to 7 - move, four
+// weapons). The variants are written to loadout/<Robot_X>_m<M>a<A>_<weapon>.cpp
+// and compiled `jobs` at a time into their own libraries. Each variant then
+// plays `matches` seeded headless free-for-alls (seeds cfg.seed, cfg.seed + 1,
+// ...) against the same opponents through run_batch(). Prints the ranking,
+// marking the loadout the source asks for. Libraries are removed afterwards
+// and the generated sources are kept.
+bool run_loadout_sweep(const std::string& cpp_file, std::vector<LoadedRobot>& opponents,
+                       const ArenaConfig& cfg, int matches, int jobs);
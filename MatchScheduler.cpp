@@ -0,0 +1,126 @@
+// Interleaved match runner: many coroutine matches per thread, no forking
+#include <bits/stdc++.h>
+#include "MatchScheduler.h"
+#include "ArenaPolicies.h"
+#include "MatchTask.h"
+#include "ResultCache.h"
+
+using namespace std;
+
+// Accepts and drops everything without a put area or any other state, so
+// robots printing on several threads at once have nothing to race on. A
+// null rdbuf would instead set badbit on the shared cout at every write.
+class NullBuf : public streambuf
+{
+protected:
+    int overflow(int ch) override { return traits_type::not_eof(ch); }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+// One in-flight match. The task refers to roster, cfg and result, so a slot
+// stays put in its thread's vector for the whole run.
+struct MatchSlot {
+    int match = -1;                 // -1 when free
+    vector<LoadedRobot> roster;     // own copy: it holds this match's robot instances
+    ArenaConfig cfg;
+    MatchResult result;
+    MatchTask task;
+};
+
+bool run_interleaved(vector<LoadedRobot>& robots, const ArenaConfig& cfg, int matches,
+                     int threads, int in_flight, BatchSummary& summary, bool report_matches) {
+    summary = BatchSummary();
+    summary.wins.assign(robots.size(), 0);
+    if (matches <= 0) return true;
+    threads = max(1, min(threads, matches));
+    in_flight = max(1, in_flight);
+
+    ArenaConfig match_cfg = cfg;
+    match_cfg.headless = true;
+    match_cfg.quiet = true;
+    match_cfg.spectator = nullptr;
+
+    // Robots print into the void, silenced here once for every thread;
+    // results go to the real stdout
+    cout.flush();
+    NullBuf discard;
+    streambuf* saved_cout = cout.rdbuf(&discard);
+    ostream report(saved_cout);
+
+    mutex lock;                     // guards everything below except next
+    atomic<int> next{0};
+    vector<unsigned long long> cache_keys(matches, 0);
+    bool ok = true;
+
+    // Helper: score one match; the caller holds lock
+    auto collect = [&](int match, bool match_ok, const MatchResult& r, bool cached) {
+        if (!match_ok) {
+            cerr << "Match " << match + 1 << " could not be set up.\n";
+            ok = false;
+            return;
+        }
+        if (!cached && cache_keys[match] && !cfg.cache->store(cache_keys[match], r)) ok = false;
+        summary.played++;
+        summary.rounds += r.rounds;
+        if (r.stalemate) summary.stalemates++;
+        if (r.winner < 0) summary.draws++;
+        else summary.wins[r.winner]++;
+        if (!report_matches) return;
+        report << "Match " << match + 1 << " (seed " << cfg.seed + (unsigned)match << "): "
+               << (r.winner < 0 ? string("draw") : robots[r.winner].cpp_file)
+               << " after " << r.rounds << " rounds" << (cached ? " (cached)" : "") << "\n";
+    };
+
+    // Helper: start the next match the cache cannot answer in slot; false
+    // once every match has been handed out
+    auto claim = [&](MatchSlot& slot) {
+        for (int match; (match = next.fetch_add(1)) < matches;) {
+            slot.task = MatchTask();    // the finished match refers to the old roster and cfg
+            slot.cfg = match_cfg;
+            slot.cfg.seed = cfg.seed + (unsigned)match;
+            slot.cfg.layout_index = (unsigned long long)match;
+            if (!cfg.trace_file.empty()) slot.cfg.trace_file = cfg.trace_file + "." + to_string(match + 1);
+            if (cfg.cache) {
+                lock_guard<mutex> guard(lock);
+                MatchResult cached;
+                cache_keys[match] = cfg.cache->key(robots, slot.cfg);
+                if (cache_keys[match] && cfg.cache->lookup(cache_keys[match], cached)) {
+                    collect(match, true, cached, true);
+                    continue;
+                }
+            }
+            slot.match = match;
+            slot.roster = robots;
+            slot.task = match_rounds<HeadlessArena>(slot.roster, slot.cfg, slot.result);
+            return true;
+        }
+        slot.match = -1;
+        return false;
+    };
+
+    auto worker = [&] {
+        vector<MatchSlot> slots(in_flight);
+        int live = 0;
+        for (auto &slot : slots) live += claim(slot);
+        while (live > 0) {
+            for (auto &slot : slots) {
+                if (slot.match < 0 || slot.task.resume()) continue;
+                {
+                    lock_guard<mutex> guard(lock);
+                    collect(slot.match, slot.task.ok(), slot.result, false);
+                }
+                if (!claim(slot)) live--;
+            }
+        }
+        add_engine_counters(take_engine_counters());
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool) t.join();
+
+    cout.clear();
+    cout.rdbuf(saved_cout);
+    return ok;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+
+#include "Arena.h"
+#include "MatchServer.h"
+
+// Play `matches` free-for-alls like run_batch(), but without a process per
+// match. Each of `threads` threads keeps up to `in_flight` matches going as
+// coroutines (match_rounds()) and resumes them round-robin, one round at a
+// time, starting the next seed whenever one finishes. Small boards finish
+// in a few dozen rounds, so this saves a fork and a page-table copy for
+// every match.
+//
+// The price is isolation. Matches share the robot libraries' globals, so a
+// robot that keeps static state can play a seed differently than it does in
+// its own worker (rand() is per robot; see RobotRandom.h), and a robot that
+// crashes takes the whole run down. Matches run with the headless policies
+// and whatever robots print is discarded. cfg.trace_file, cfg.cache and
+// cfg.layouts work as in run_batch().
+bool run_interleaved(std::vector<LoadedRobot>& robots, const ArenaConfig& cfg, int matches,
+                     int threads, int in_flight, BatchSummary& summary, bool report_matches = true);
@@ -0,0 +1,229 @@
+// Pre-forking match server: one process per match, results over shared memory
+#include <bits/stdc++.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "HotReload.h"
+#include "MatchServer.h"
+#include "ResultCache.h"
+
+using namespace std;
+
+// Helper: a pollable fd that becomes readable when child pid exits, or -1.
+// Through syscall() since older glibc headers declare no C-linkage wrapper.
+static int open_pidfd(pid_t pid) {
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+}
+
+static_assert(atomic<uint32_t>::is_always_lock_free, "result slots need lock-free atomics across processes");
+
+// One published result, followed by the place of every robot and padded to
+// a cache line (see ResultSlots::create) so workers finishing together do
+// not share lines.
+struct ResultSlot {
+    atomic<uint32_t> ready;
+    int rounds;
+    int winner;
+    int stalemate;
+    int ok;
+    EngineCounters counters;        // the worker's, for the parent's metrics
+};
+
+// One result slot per running worker in a MAP_SHARED mapping. The parent
+// hands a free slot to each worker it forks and reads that slot once it has
+// reaped the worker, so a result never waits behind a slower worker's and a
+// slot is never reused before it has been read. A slot still not ready
+// after its worker exited means the worker died before publishing.
+class ResultSlots
+{
+private:
+    void* m_mem = MAP_FAILED;
+    size_t m_bytes = 0;
+    size_t m_stride = 0;
+    size_t m_robots = 0;
+
+    ResultSlot* slot(size_t i) { return (ResultSlot*)((char*)m_mem + i * m_stride); }
+    static int* places(ResultSlot* s) { return (int*)(s + 1); }
+
+public:
+    ~ResultSlots() {
+        if (m_mem != MAP_FAILED) munmap(m_mem, m_bytes);
+    }
+
+    bool create(size_t capacity, size_t robots) {
+        m_robots = robots;
+        m_stride = (sizeof(ResultSlot) + robots * sizeof(int) + 63) / 64 * 64;
+        m_bytes = capacity * m_stride;
+        m_mem = mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (m_mem == MAP_FAILED) {
+            cerr << "mmap for result slots failed: " << strerror(errno) << "\n";
+            return false;
+        }
+        // anonymous mappings are zeroed: every slot not ready
+        for (size_t i = 0; i < capacity; ++i) new (&slot(i)->ready) atomic<uint32_t>(0);
+        return true;
+    }
+
+    // worker side
+    void publish(size_t i, bool ok, const MatchResult& r, const EngineCounters& counters) {
+        ResultSlot* s = slot(i);
+        s->rounds = r.rounds;
+        s->winner = r.winner;
+        s->stalemate = r.stalemate;
+        s->ok = ok;
+        s->counters = counters;
+        for (size_t j = 0; j < m_robots; ++j) places(s)[j] = j < r.place.size() ? r.place[j] : 0;
+        s->ready.store(1, memory_order_release);
+    }
+
+    // parent side, after reaping slot i's worker: read its result and free
+    // the slot; false if the worker never published
+    bool take(size_t i, bool& ok, MatchResult& r, EngineCounters& counters) {
+        ResultSlot* s = slot(i);
+        if (!s->ready.load(memory_order_acquire)) return false;
+        r.rounds = s->rounds;
+        r.winner = s->winner;
+        r.stalemate = s->stalemate;
+        r.place.assign(places(s), places(s) + m_robots);
+        ok = s->ok;
+        counters = s->counters;
+        s->ready.store(0, memory_order_relaxed);
+        return true;
+    }
+};
+
+bool run_batch(vector<LoadedRobot>& robots, const ArenaConfig& cfg,
+               int matches, int jobs, BatchSummary& summary, bool report_matches,
+               RobotWatcher* watcher) {
+    summary = BatchSummary();
+    summary.wins.assign(robots.size(), 0);
+    if (matches <= 0) return true;
+    jobs = max(1, min(jobs, matches));
+
+    ResultSlots slots;
+    if (!slots.create((size_t)jobs, robots.size())) return false;
+    vector<size_t> free_slots;
+    for (int i = jobs - 1; i >= 0; --i) free_slots.push_back((size_t)i);
+
+    ArenaConfig match_cfg = cfg;
+    match_cfg.headless = true;
+    match_cfg.quiet = true;
+
+    vector<unsigned long long> cache_keys(matches, 0);
+    // worker pid -> match index, result slot and pidfd. Only these pids are
+    // waited for: a watcher's compiler, run through system() from another
+    // thread, is a child too and must be left to its own waitpid.
+    struct Worker {
+        int match;
+        size_t slot;
+        int pidfd;
+    };
+    map<pid_t, Worker> running;
+    bool ok = true;
+
+    auto collect = [&](int match, bool match_ok, const MatchResult& r, bool cached) {
+        if (!match_ok) {
+            cerr << "Match " << match + 1 << " could not be set up.\n";
+            ok = false;
+            return;
+        }
+        if (!cached && cache_keys[match] && !cfg.cache->store(cache_keys[match], r)) ok = false;
+        summary.played++;
+        summary.rounds += r.rounds;
+        if (r.stalemate) summary.stalemates++;
+        if (r.winner < 0) summary.draws++;
+        else summary.wins[r.winner]++;
+        if (!report_matches) return;
+        cout << "Match " << match + 1 << " (seed " << cfg.seed + (unsigned)match << "): "
+             << (r.winner < 0 ? string("draw") : robots[r.winner].cpp_file)
+             << " after " << r.rounds << " rounds" << (cached ? " (cached)" : "") << "\n";
+    };
+
+    int next = 0;
+    while (next < matches || !running.empty()) {
+        while (next < matches && (int)running.size() < jobs) {
+            // running workers have their own copy of the old libraries
+            if (watcher) watcher->apply(robots, false);
+            if (cfg.cache) {
+                match_cfg.seed = cfg.seed + (unsigned)next;
+                match_cfg.layout_index = (unsigned long long)next;
+                MatchResult cached;
+                cache_keys[next] = cfg.cache->key(robots, match_cfg);
+                if (cache_keys[next] && cfg.cache->lookup(cache_keys[next], cached)) {
+                    collect(next++, true, cached, true);
+                    continue;
+                }
+            }
+            // anything still buffered would be written again by the child
+            cout.flush();
+            cerr.flush();
+            pid_t pid = fork();
+            if (pid < 0) {
+                cerr << "fork failed: " << strerror(errno) << "\n";
+                ok = false;
+                matches = next;     // stop launching, finish what is running
+                break;
+            }
+            if (pid == 0) {
+                take_engine_counters();     // the parent's counts stay with the parent
+                match_cfg.seed = cfg.seed + (unsigned)next;
+                match_cfg.layout_index = (unsigned long long)next;
+                if (!cfg.trace_file.empty()) match_cfg.trace_file = cfg.trace_file + "." + to_string(next + 1);
+                MatchResult result;
+                bool match_ok = run_match(robots, match_cfg, result);
+                slots.publish(free_slots.back(), match_ok, result, take_engine_counters());
+                // exit() rather than _exit() so profiling runtimes
+                // (-fprofile-generate, gcov) write out this worker's counts
+                exit(0);
+            }
+            // -1 (no pidfd support) falls back to polling below
+            running[pid] = {next++, free_slots.back(), open_pidfd(pid)};
+            free_slots.pop_back();
+        }
+        if (running.empty()) break;
+
+        vector<pollfd> pfds;
+        bool polling = false;
+        for (auto &[pid, w] : running) {
+            pfds.push_back({w.pidfd, POLLIN, 0});
+            polling |= w.pidfd < 0;
+        }
+        if (poll(pfds.data(), pfds.size(), polling ? 10 : -1) < 0 && errno != EINTR) {
+            cerr << "poll on batch workers failed: " << strerror(errno) << "\n";
+            return false;
+        }
+
+        for (auto it = running.begin(); it != running.end();) {
+            int status = 0;
+            pid_t pid = waitpid(it->first, &status, WNOHANG);
+            if (pid == 0 || (pid < 0 && errno == EINTR)) {
+                ++it;
+                continue;
+            }
+            if (pid < 0) {
+                cerr << "waitpid failed: " << strerror(errno) << "\n";
+                return false;
+            }
+            auto [match, slot, pidfd] = it->second;
+            it = running.erase(it);
+            if (pidfd >= 0) close(pidfd);
+            free_slots.push_back(slot);
+
+            bool match_ok = false;
+            MatchResult result;
+            EngineCounters counters;
+            if (slots.take(slot, match_ok, result, counters)) {
+                add_engine_counters(counters);
+                collect(match, match_ok, result, false);
+            } else {
+                summary.crashed++;
+                cerr << "Match " << match + 1 << " (seed " << cfg.seed + (unsigned)match << ") worker ";
+                if (WIFSIGNALED(status)) cerr << "killed by signal " << WTERMSIG(status) << "\n";
+                else cerr << "exited with status " << WEXITSTATUS(status) << "\n";
+            }
+        }
+    }
+    return ok;
+}
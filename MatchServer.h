@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "Arena.h"
+
+class RobotWatcher;
+
+// Totals for a batch of free-for-all matches
+struct BatchSummary {
+    int played = 0;
+    int draws = 0;
+    int stalemates = 0;
+    int crashed = 0;                // workers that died before reporting
+    long long rounds = 0;
+    std::vector<int> wins;          // per robot, same order as robots
+};
+
+// Play `matches` free-for-all matches with seeds cfg.seed, cfg.seed + 1, ...
+// (and layouts 0, 1, ... when cfg.layouts is set).
+// Robots are compiled and dlopen'ed once by the caller. Each match then runs
+// in a fork()ed worker that inherits the loaded libraries copy-on-write, so
+// robot globals and statics (rand() state, caches) never leak between
+// matches. At most `jobs` workers run at a time. Each reports its result and
+// engine counters through its own shared-memory slot, which the parent reads
+// when it reaps it. With cfg.trace_file set, match N (from 1) traces to
+// "<trace_file>.N". With cfg.cache set, stored matches are scored without
+// forking a worker and played ones are stored.
+// With a watcher, robots rebuilt since the last fork are swapped into robots
+// before the next one; workers already running keep the build they forked
+// with. Robots new to the directory are not added, so the roster and the
+// summary keep their shape.
+// Each result is printed as it comes in unless report_matches is false.
+bool run_batch(std::vector<LoadedRobot>& robots, const ArenaConfig& cfg,
+               int matches, int jobs, BatchSummary& summary, bool report_matches = true,
+               RobotWatcher* watcher = nullptr);
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <coroutine>
+#include <utility>
+
+// One match as a C++20 coroutine (see match_rounds() in Arena.h). It starts
+// suspended; each resume() plays one round and returns false once the match
+// is over, after which ok() is what run_match() would have returned.
+// Destroying the task mid-match tears the match down like an early return.
+class MatchTask
+{
+public:
+    struct promise_type {
+        bool ok = false;
+
+        MatchTask get_return_object() {
+            return MatchTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(bool value) { ok = value; }
+        void unhandled_exception() { throw; }
+    };
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+
+    explicit MatchTask(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+public:
+    MatchTask() = default;
+    MatchTask(MatchTask&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    MatchTask& operator=(MatchTask&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    ~MatchTask() {
+        if (m_handle) m_handle.destroy();
+    }
+
+    // Play the next round; false once the match has finished
+    bool resume() {
+        if (!m_handle || m_handle.done()) return false;
+        m_handle.resume();
+        return !m_handle.done();
+    }
+
+    bool ok() const { return m_handle && m_handle.done() && m_handle.promise().ok; }
+};
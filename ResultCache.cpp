@@ -0,0 +1,155 @@
+// Result cache: skip matches whose inputs were already played
+#include <bits/stdc++.h>
+#include "LayoutCorpus.h"
+#include "ResultCache.h"
+#include "Zobrist.h"
+
+using namespace std;
+
+// Helper: fold a file's bytes into a 64-bit digest; false if it cannot be read
+static bool digest_file(const string& path, unsigned long long& digest) {
+    ifstream in(path, ios::binary);
+    if (!in) return false;
+    string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    unsigned long long h = zobrist_mix(bytes.size());
+    size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8) {
+        unsigned long long word;
+        memcpy(&word, bytes.data() + i, 8);
+        h = zobrist_mix(h ^ word);
+    }
+    unsigned long long tail = 0;
+    memcpy(&tail, bytes.data() + i, bytes.size() - i);
+    digest = zobrist_mix(h ^ tail);
+    return true;
+}
+
+// Helper: "won by robot 2 after 80 rounds" for a mismatch report
+static string describe(const MatchResult& r) {
+    return (r.winner < 0 ? string("a draw") : "won by robot " + to_string(r.winner)) + " after "
+           + to_string(r.rounds) + " rounds";
+}
+
+// Helper: true when two results would score a match the same way
+static bool same_outcome(const MatchResult& a, const MatchResult& b) {
+    return a.rounds == b.rounds && a.winner == b.winner && a.stalemate == b.stalemate && a.place == b.place;
+}
+
+bool ResultCache::open(const string& path, double verify_fraction, unsigned seed) {
+    m_path = path;
+    m_verify_fraction = verify_fraction;
+    m_rng.seed(seed);
+
+    // The rules live in the arena binary, the robot plumbing in RobotBase.o
+    unsigned long long exe = 0, base = 0;
+    if (!digest_file("/proc/self/exe", exe) || !digest_file("RobotBase.o", base)) {
+        cerr << "Result cache needs to read the arena executable and RobotBase.o\n";
+        return false;
+    }
+    m_build_digest = zobrist_mix(exe ^ zobrist_mix(base));
+
+    bool fresh = true;
+    if (ifstream in{path}) {
+        fresh = false;
+        string line;
+        int line_no = 0;
+        while (getline(in, line)) {
+            line_no++;
+            if (line.empty() || line[0] == '#') continue;
+            istringstream fields(line);
+            unsigned long long key;
+            MatchResult r;
+            int stalemate;
+            if (!(fields >> hex >> key >> dec >> r.rounds >> r.winner >> stalemate)) {
+                cerr << path << ":" << line_no << ": bad cache entry\n";
+                return false;
+            }
+            r.stalemate = stalemate;
+            for (int place; fields >> place;) r.place.push_back(place);
+            m_results[key] = r;
+        }
+    }
+
+    m_out.open(path, ios::app);
+    if (!m_out) {
+        cerr << "Could not write result cache " << path << "\n";
+        return false;
+    }
+    if (fresh) m_out << "# RobotWarz result cache: key rounds winner stalemate place...\n";
+    return true;
+}
+
+unsigned long long ResultCache::key(const vector<LoadedRobot>& robots, const ArenaConfig& cfg) {
+    if (!cfg.trace_file.empty() || !cfg.call_trace_dir.empty() || cfg.phase_times || cfg.report_usage
+        || cfg.cpu_cap_sec > 0 || cfg.heatmap)
+        return 0;
+
+    unsigned long long h = m_build_digest;
+    for (auto &lr : robots) {
+        auto it = m_library_digests.find(lr.so_file);
+        if (it == m_library_digests.end()) {
+            unsigned long long digest;
+            if (!digest_file(lr.so_file, digest)) return 0;
+            it = m_library_digests.emplace(lr.so_file, digest).first;
+        }
+        h = zobrist_mix(h ^ it->second);
+    }
+    for (long long field : {(long long)cfg.rows, (long long)cfg.cols, (long long)cfg.num_flames,
+                            (long long)cfg.num_pits, (long long)cfg.num_mounds, (long long)cfg.max_rounds,
+                            (long long)cfg.stall_rounds, (long long)cfg.repeat_limit, (long long)cfg.tiebreak,
+                            cfg.heap_cap_bytes, (long long)cfg.seed})
+        h = zobrist_mix(h ^ (unsigned long long)field);
+
+    // A stored layout replaces the one the seed would draw
+    if (cfg.layouts) {
+        const uint64_t* layout = cfg.layouts->layout_for(cfg, robots.size());
+        if (!layout) return 0;
+        for (uint32_t k = 0; k < cfg.layouts->header().record_cells; ++k) h = zobrist_mix(h ^ layout[k]);
+    }
+    return h ? h : 1;
+}
+
+bool ResultCache::lookup(unsigned long long key, MatchResult& result) {
+    auto it = m_results.find(key);
+    if (it == m_results.end()) {
+        m_misses++;
+        return false;
+    }
+    if (m_verify_fraction > 0 && uniform_real_distribution<double>(0, 1)(m_rng) < m_verify_fraction) {
+        m_verified++;
+        return false;
+    }
+    m_hits++;
+    result = it->second;
+    return true;
+}
+
+bool ResultCache::store(unsigned long long key, const MatchResult& result) {
+    auto it = m_results.find(key);
+    if (it != m_results.end() && !same_outcome(it->second, result)) {
+        m_changed++;
+        cerr << "Result cache: match " << hex << key << dec << " was " << describe(it->second)
+             << ", replayed as " << describe(result) << "; is a robot nondeterministic?\n";
+    }
+    m_results[key] = result;
+
+    // one flushed line per match, so forked workers never inherit a buffer
+    m_out << hex << key << dec << " " << result.rounds << " " << result.winner << " " << result.stalemate;
+    for (int place : result.place) m_out << " " << place;
+    m_out << "\n" << flush;
+    if (!m_out) {
+        cerr << "Could not write result cache " << m_path << "\n";
+        return false;
+    }
+    return true;
+}
+
+void ResultCache::print_summary() const {
+    // re-verified hits are played like misses, so they count as played
+    cout << "Result cache " << m_path << ": " << m_hits << " hits, " << m_misses + m_verified << " played";
+    if (m_verify_fraction > 0) {
+        cout << " (" << m_misses << " misses, " << m_verified << " re-verified hits, "
+             << m_changed << " changed)";
+    }
+    cout << "\n";
+}
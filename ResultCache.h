@@ -0,0 +1,60 @@
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.h"
+
+// Match results remembered across runs (--cache FILE). A match is keyed by a
+// hash of everything that decides it: the bytes of each robot library in
+// roster order, RobotBase.o, the arena executable, the board config, the
+// seed and the starting layout when one comes from a corpus. Results are
+// appended to a text file, one line per match:
+//     key rounds winner stalemate place...
+// so an interrupted run keeps every match it finished, and a later line for
+// the same key replaces an earlier one on load.
+//
+// A hit is only as good as the robots are deterministic: a robot that reads
+// the clock, the environment (TETO_BUDGET_US, ...) or files can play the
+// same inputs differently. verify_fraction replays that share of the hits
+// and reports any whose result changed.
+class ResultCache
+{
+private:
+    std::string m_path;
+    std::ofstream m_out;
+    std::unordered_map<unsigned long long, MatchResult> m_results;
+    std::map<std::string, unsigned long long> m_library_digests;  // by .so path
+    unsigned long long m_build_digest = 0;  // arena executable and RobotBase.o
+    double m_verify_fraction = 0;
+    std::mt19937 m_rng;
+    int m_hits = 0;
+    int m_misses = 0;
+    int m_verified = 0;
+    int m_changed = 0;
+
+public:
+    // Load path (missing is fine) and open it for appending
+    bool open(const std::string& path, double verify_fraction, unsigned seed);
+
+    // Key for robots playing one match under cfg, or 0 when the match has
+    // side effects a stored result cannot reproduce (traces, call records,
+    // phase timing, usage reports, a CPU cap, a heatmap) or a library cannot
+    // be read
+    unsigned long long key(const std::vector<LoadedRobot>& robots, const ArenaConfig& cfg);
+
+    // Fill result and return true on a hit. Hits picked for re-verification
+    // return false so the caller plays the match and stores it again.
+    bool lookup(unsigned long long key, MatchResult& result);
+
+    // Remember a played match, checking it against any result already held
+    bool store(unsigned long long key, const MatchResult& result);
+
+    // One line: hits taken from the cache, matches played (misses plus
+    // re-verified hits) and, when verifying, how many results changed
+    void print_summary() const;
+};
@@ -0,0 +1,39 @@
+// rand() and friends for robot libraries, one stream per robot
+#include <cstdlib>
+#include "RobotRandom.h"
+#include "Zobrist.h"
+
+// Stream for rand() calls outside robot code, seeded as if by srand(1)
+static thread_local RobotRandom t_default{zobrist_mix(1)};
+static thread_local RobotRandom* t_random = nullptr;
+
+RobotRandom robot_random(unsigned seed, int index) {
+    return RobotRandom{zobrist_mix(zobrist_mix(seed) ^ (unsigned long long)index)};
+}
+
+RobotRandom* swap_robot_random(RobotRandom* random) {
+    RobotRandom* outer = t_random;
+    t_random = random;
+    return outer;
+}
+
+// Helper: next value of the running robot's stream, 0 .. RAND_MAX like glibc
+static int next_random() {
+    RobotRandom& r = t_random ? *t_random : t_default;
+    return (int)(zobrist_mix(r.state++) >> 33);
+}
+
+// Helper: restart the running robot's stream
+static void seed_random(unsigned seed) {
+    RobotRandom& r = t_random ? *t_random : t_default;
+    r.state = zobrist_mix(seed);
+}
+
+extern "C" {
+
+int rand() noexcept { return next_random(); }
+long random() noexcept { return next_random(); }
+void srand(unsigned seed) noexcept { seed_random(seed); }
+void srandom(unsigned seed) noexcept { seed_random(seed); }
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Per-robot random streams. RobotRandom.cpp defines rand, srand, random and
+// srandom in the arena executable, and the Makefile exports exactly those
+// symbols, so robot libraries bind to them instead of to libc's. Inside a
+// RobotCodeScope they draw from that robot's own RobotRandom, seeded from
+// the match seed and the robot's place in the roster, and srand() reseeds
+// only that robot. A match then plays the same however many others share
+// its process or thread. Outside robot code each thread has one stream,
+// seeded like libc's.
+//
+// Other sources of chance (drand48, <random> engines, the clock) are not
+// covered.
+struct RobotRandom {
+    unsigned long long state = 0;
+};
+
+// Stream for robot `index` of the match played with `seed`
+RobotRandom robot_random(unsigned seed, int index);
+
+// Point this thread's rand() at random (null: the thread's own stream);
+// returns the previous stream
+RobotRandom* swap_robot_random(RobotRandom* random);
@@ -0,0 +1,148 @@
+// RobotReplay: replay one robot's recorded match inputs (RobotWarzArena
+// --record-calls DIR) against its library, with no arena and no other
+// robots, and time every callback. Each pass builds a fresh robot, sets it
+// to the recorded state before every turn and feeds it the recorded radar
+// results, so robot authors can profile against real game inputs. Robot
+// code draws rand() from the same stream the arena gave it in the match.
+#include <bits/stdc++.h>
+#include <dlfcn.h>
+#include "CallTrace.h"
+#include "RobotRandom.h"
+
+using namespace std;
+
+// Time spent in one kind of callback, one sample per call
+struct CallTimes {
+    const char* name;
+    vector<long long> ns;
+};
+
+// Helper: time fn and add a sample to times
+template <class Fn>
+void timed(CallTimes& times, Fn fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    times.ns.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+}
+
+// Helper: one report line: calls, total, mean and percentiles
+void report(CallTimes& times) {
+    if (times.ns.empty()) {
+        cout << setw(24) << left << times.name << right << "   no calls\n";
+        return;
+    }
+    sort(times.ns.begin(), times.ns.end());
+    long long total = accumulate(times.ns.begin(), times.ns.end(), 0LL);
+    auto pct = [&](double p) { return times.ns[min(times.ns.size() - 1, (size_t)(p * times.ns.size()))]; };
+    cout << setw(24) << left << times.name << right
+         << setw(10) << times.ns.size()
+         << setw(12) << fixed << setprecision(3) << total / 1e6
+         << setw(10) << total / (long long)times.ns.size()
+         << setw(10) << pct(0.50) << setw(10) << pct(0.99) << setw(12) << times.ns.back() << "\n";
+    cout.unsetf(ios::fixed);
+}
+
+int main(int argc, char** argv) {
+    string trace_path, so_path;
+    int repeat = 1;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc) {
+            try {
+                repeat = stoi(argv[++i]);
+            } catch (const exception&) {
+                repeat = 0;
+            }
+        } else if (trace_path.empty()) {
+            trace_path = arg;
+        } else if (so_path.empty()) {
+            so_path = arg;
+        } else {
+            trace_path.clear();
+            break;
+        }
+    }
+    if (trace_path.empty() || repeat < 1) {
+        cerr << "Usage: " << argv[0] << " TRACE.calls [LIBRARY.so] [--repeat N]\n"
+             << "  LIBRARY defaults to ./lib<robot>.so as built by the arena\n";
+        return 1;
+    }
+
+    CallTrace trace;
+    if (!trace.load(trace_path)) {
+        cerr << "Cannot read call trace " << trace_path << "\n";
+        return 1;
+    }
+    if (so_path.empty()) so_path = "./lib" + trace.name + ".so";
+
+    void* handle = dlopen(so_path.c_str(), RTLD_NOW);
+    if (!handle) {
+        cerr << "dlopen failed for " << so_path << ": " << dlerror() << "\n";
+        return 1;
+    }
+    RobotFactory factory = (RobotFactory)dlsym(handle, "create_robot");
+    if (!factory) {
+        cerr << "dlsym create_robot failed in " << so_path << ": " << dlerror() << "\n";
+        dlclose(handle);
+        return 1;
+    }
+
+    size_t samples = trace.turns.size() * repeat;
+    CallTimes radar{"get_radar_direction", {}}, results{"process_radar_results", {}};
+    CallTimes shot{"get_shot_location", {}}, move{"get_move_direction", {}};
+    for (CallTimes* t : {&radar, &results, &shot, &move}) t->ns.reserve(samples);
+
+    size_t differ = 0;
+    auto start = chrono::steady_clock::now();
+    for (int pass = 0; pass < repeat; ++pass) {
+        // Seeded as in the match and live from the constructor on, as
+        // RobotCodeScope does in the arena
+        RobotRandom random = robot_random(trace.header.seed, trace.header.robot);
+        RobotRandom* outer_random = swap_robot_random(&random);
+        RobotBase* robot = factory();
+        if (!robot) {
+            cerr << "create_robot returned null for " << so_path << "\n";
+            dlclose(handle);
+            return 1;
+        }
+        robot->set_boundaries(trace.header.rows, trace.header.cols);
+
+        for (size_t k = 0; k < trace.turns.size(); ++k) {
+            const CallTurn& t = trace.turns[k];
+            int radar_dir = 0, shot_r = -1, shot_c = -1, move_dir = 0, move_dist = 0;
+            bool shooting = false;
+
+            apply_call_state(robot, t.state);
+            timed(radar, [&] { robot->get_radar_direction(radar_dir); });
+            timed(results, [&] { robot->process_radar_results(trace.radar[k]); });
+            timed(shot, [&] { shooting = robot->get_shot_location(shot_r, shot_c); });
+            if (t.asked_move) {
+                apply_call_state(robot, t.move_state);
+                timed(move, [&] { robot->get_move_direction(move_dir, move_dist); });
+            }
+
+            if (pass == 0 && (radar_dir != t.radar_dir || shooting != (bool)t.shooting
+                              || (shooting && (shot_r != t.shot_r || shot_c != t.shot_c))
+                              || (t.asked_move && (move_dir != t.move_dir || move_dist != t.move_dist))))
+                differ++;
+        }
+        delete robot;
+        swap_robot_random(outer_random);
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    cout << trace.name << ": " << trace.turns.size() << " turns on a " << trace.header.rows << "x"
+         << trace.header.cols << " board (seed " << trace.header.seed << ", robot "
+         << trace.header.robot << "), " << repeat << " passes\n\n";
+    cout << setw(24) << left << "callback" << right << setw(10) << "calls" << setw(12) << "total ms"
+         << setw(10) << "mean ns" << setw(10) << "p50 ns" << setw(10) << "p99 ns" << setw(12) << "max ns" << "\n";
+    for (CallTimes* t : {&radar, &results, &shot, &move}) report(*t);
+    cout << "\n" << fixed << setprecision(0) << samples / max(elapsed.count(), 1e-9) << " turns/s\n";
+    if (differ) {
+        cout << differ << " of " << trace.turns.size() << " turns answered differently than in the match"
+             << " (the robot uses the clock, another random source or state the trace does not hold)\n";
+    }
+
+    dlclose(handle);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include "RobotBase.h"
+
+// Structure-of-arrays copy of the robot state the arena reads in its hot
+// loops. Scans, hit tests and win checks walk these packed arrays instead of
+// calling getters through each RobotBase*. The arena updates an entry at the
+// same places it calls move_to(), take_damage() and friends on the robot.
+// alive, can_move and died_round are arena-owned and live only here.
+struct RobotTable
+{
+    std::vector<int> row;
+    std::vector<int> col;
+    std::vector<int> health;
+    std::vector<int> armor;
+    std::vector<int> grenades;
+    std::vector<WeaponType> weapon;
+    std::vector<char> alive;
+    std::vector<char> can_move;
+    std::vector<int> died_round;    // -1 while alive
+
+    size_t size() const { return row.size(); }
+
+    // One dead, empty entry per robot
+    void reset(size_t n) {
+        row.assign(n, -1);
+        col.assign(n, -1);
+        health.assign(n, 0);
+        armor.assign(n, 0);
+        grenades.assign(n, 0);
+        weapon.assign(n, hammer);
+        alive.assign(n, 0);
+        can_move.assign(n, 1);
+        died_round.assign(n, -1);
+    }
+
+    // Copy everything from a freshly placed robot and mark it alive
+    void load(size_t i, RobotBase* r) {
+        r->get_current_location(row[i], col[i]);
+        health[i] = r->get_health();
+        armor[i] = r->get_armor();
+        grenades[i] = r->get_grenades();
+        weapon[i] = r->get_weapon();
+        alive[i] = 1;
+        can_move[i] = 1;
+        died_round[i] = -1;
+    }
+
+    // Index of the live robot at (r, c), or -1
+    int find_at(int r, int c) const {
+        for (size_t i = 0; i < row.size(); ++i) {
+            if (alive[i] && row[i] == r && col[i] == c) return (int)i;
+        }
+        return -1;
+    }
+};
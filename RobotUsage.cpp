@@ -0,0 +1,81 @@
+// Global allocator that charges heap use to the robot whose code is running
+#include <cstdlib>
+#include <ctime>
+#include <malloc.h>
+#include <new>
+#include "RobotUsage.h"
+
+// The robot whose callback is running on this thread, or null in arena code
+static thread_local RobotUsage* t_robot = nullptr;
+
+#ifdef ROBOTWARZ_ALLOC_CHECK
+static thread_local unsigned long long t_arena_allocs = 0;
+
+unsigned long long arena_allocations() {
+    return t_arena_allocs;
+}
+#endif
+
+// Helper: thread CPU time in nanoseconds
+static long long thread_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+RobotCodeScope::RobotCodeScope(RobotUsage& usage, RobotRandom& random, bool measure_cpu)
+    : m_outer(t_robot), m_usage(&usage), m_outer_random(swap_robot_random(&random)) {
+    t_robot = m_usage;
+    if (measure_cpu) m_cpu_start_ns = thread_cpu_ns();
+}
+
+RobotCodeScope::~RobotCodeScope() {
+    if (m_cpu_start_ns >= 0) m_usage->cpu_sec += (thread_cpu_ns() - m_cpu_start_ns) * 1e-9;
+    t_robot = m_outer;
+    swap_robot_random(m_outer_random);
+}
+
+// Helper: charge a fresh block to the running robot
+static void* charge(void* p) {
+    if (!p) return p;
+    if (RobotUsage* u = t_robot) {
+        u->allocations++;
+        u->heap_bytes += malloc_usable_size(p);
+        if (u->heap_bytes > u->heap_peak) u->heap_peak = u->heap_bytes;
+    }
+#ifdef ROBOTWARZ_ALLOC_CHECK
+    else {
+        t_arena_allocs++;
+    }
+#endif
+    return p;
+}
+
+// Helper: credit a block back to the running robot and free it
+static void release(void* p) {
+    if (!p) return;
+    if (RobotUsage* u = t_robot) u->heap_bytes -= malloc_usable_size(p);
+    std::free(p);
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = charge(std::malloc(size ? size : 1))) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return charge(std::malloc(size ? size : 1));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "RobotRandom.h"
+
+// Per-robot resource accounting. RobotUsage.cpp replaces the global
+// operator new and delete, and the arena runs every robot callback inside a
+// RobotCodeScope naming that robot's RobotUsage, so heap traffic is charged
+// to whichever robot's code is running. The scope also selects the robot's
+// rand() stream (see RobotRandom.h). Memory a robot frees is credited
+// back to the robot running at the time. Thread CPU time is charged too when
+// the scope is asked to measure it; that costs two clock_gettime calls per
+// callback, so it is off unless usage is reported or capped.
+//
+// Allocation checking for test builds (-DROBOTWARZ_ALLOC_CHECK, see
+// "make alloc-check") counts every allocation made outside robot code.
+struct RobotUsage {
+    double cpu_sec = 0;             // thread CPU time inside callbacks
+    long long heap_bytes = 0;       // allocated minus freed, in malloc's usable bytes
+    long long heap_peak = 0;
+    unsigned long long allocations = 0;
+};
+
+class RobotCodeScope
+{
+private:
+    RobotUsage* m_outer;
+    RobotUsage* m_usage;
+    RobotRandom* m_outer_random;
+    long long m_cpu_start_ns = -1;  // -1 when not measuring
+
+public:
+    RobotCodeScope(RobotUsage& usage, RobotRandom& random, bool measure_cpu = false);
+    ~RobotCodeScope();
+    RobotCodeScope(const RobotCodeScope&) = delete;
+    RobotCodeScope& operator=(const RobotCodeScope&) = delete;
+};
+
+#ifdef ROBOTWARZ_ALLOC_CHECK
+
+// operator new calls made outside robot code so far on this thread
+unsigned long long arena_allocations();
+
+#else
+
+inline unsigned long long arena_allocations() { return 0; }
+
+#endif
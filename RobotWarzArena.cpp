@@ -1,485 +1,432 @@
-// Updated RobotWarzArena.cpp
-#include <bits/stdc++.h>
-#include <dlfcn.h>
-#include <filesystem>
-#include "RobotBase.h"
-#include "RadarObj.h"
-#include <algorithm>
-#include <iostream>
-
-using namespace std;
-namespace fs = std::filesystem;
-
-static const int BOARD_ROWS = 20;
-static const int BOARD_COLS = 20;
-static const char FLAME_OBS = 'F';
-static const char PIT_OBS = 'P';
-static const char MOUND_OBS = 'M';
-
-struct LoadedRobot {
-    string cpp_file;
-    string so_file;
-    void* handle = nullptr;
-    RobotBase* robot_instance = nullptr;
-    bool alive = false;
-    bool is_dead = false;
-    std::set<int> blocked_dirs;
-    bool can_move_flag = true;
-};
-
-// Helper: compile a robot implementation (Robot_X.cpp) into a libRobot_X.so
-bool compile_robot(const string& cpp, string& out_so) {
-    string base = cpp.substr(0, cpp.find(".cpp"));
-    out_so = "./lib" + base + ".so";
-    string cmd = "g++ -shared -fPIC -o " + out_so + " " + cpp + " RobotBase.o -I. -std=c++20";
-    cerr << "Compiling: " << cmd << "\n";
-    return system(cmd.c_str()) == 0;
-}
-
-// Helper: Obstacles
-void place_obstacles(vector<vector<char>>& board) {
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> rdist(0, BOARD_ROWS - 1);
-    uniform_int_distribution<> cdist(0, BOARD_COLS - 1);
-
-    int num_flames = 10;
-    int num_pits = 2;
-    int num_mounds = 10;
-
-    auto place = [&](char ch, int count) {
-        while (count--) {
-            int r, c;
-            do {
-                r = rdist(gen);
-                c = cdist(gen);
-            } while (board[r][c] != '.');
-            board[r][c] = ch;
-        }
-    };
-
-    place(FLAME_OBS, num_flames);
-    place(PIT_OBS, num_pits);
-    place(MOUND_OBS, num_mounds);
-}
-
-// Place robots on the board at random free cells
-void place_robots_random(vector<LoadedRobot>& robots, vector<vector<char>>& board) {
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> rdist(0, BOARD_ROWS - 1);
-    uniform_int_distribution<> cdist(0, BOARD_COLS -1);
-
-    for (auto &lr : robots) {
-        if (!lr.robot_instance) continue;
-        int r, c;
-        do {
-            r = rdist(gen);
-            c = cdist(gen);
-        } while (board[r][c] != '.');
-
-        lr.robot_instance->move_to(r,c);
-        lr.robot_instance->set_boundaries(BOARD_ROWS, BOARD_COLS);
-        board[r][c] = lr.robot_instance->m_character;
-        lr.alive = true;
-
-        cout << "Loaded robot: " << lr.robot_instance->m_name
-             << " at (" << r << "," << c << ")\n";
-    }
-}
-
-// Print board nicely
-void print_board(const vector<vector<char>>& board) {
-    cout << "\n=========== board ===========\n";
-    cout << " ";
-    for (int c = 0; c < BOARD_COLS; ++c) cout << setw(3) << c;
-    cout << "\n\n";
-    for (int r = 0; r < BOARD_ROWS; ++r) {
-        cout << setw(3) << r << " ";
-        for (int c = 0; c < BOARD_COLS; ++c) {
-            cout << setw(3) << board[r][c];
-        }
-        cout << "\n\n";
-    }
-}
-
-// Helper to find robot index at a position
-int find_robot_at(const vector<LoadedRobot>& robots, int row, int col, bool include_dead = false) {
-    for (size_t i = 0; i < robots.size(); ++i) {
-        if (!robots[i].robot_instance) continue;
-        if (!include_dead && !robots[i].alive) continue;
-        int rr, cc;
-        robots[i].robot_instance->get_current_location(rr, cc);
-        if (rr == row && cc == col) return (int)i;
-    }
-    return -1;
-}
-
-
-void mark_robot_dead(LoadedRobot& lr, vector<vector<char>>& board) {
-    if (!lr.robot_instance) return;
-    int r, c;
-    lr.robot_instance->get_current_location(r, c);
-    board[r][c] = 'X';
-    lr.alive = false;
-    lr.is_dead = true;
-}
-
-
-// Build radar results for a robot scanning in a given direction
-vector<RadarObj> do_radar_scan(RobotBase* robot, int direction, const vector<vector<char>>& board, const vector<LoadedRobot>& robots) {
-    vector<RadarObj> res;
-    if (direction <= 0 || direction > 8) return res;
-
-    int r0, c0;
-    robot->get_current_location(r0, c0);
-    auto [dr, dc] = directions[direction];
-
-    int r = r0 + dr, c = c0 + dc;
-    while (r >= 0 && r < BOARD_ROWS && c >= 0 && c < BOARD_COLS) {
-        int idx = find_robot_at(robots, r, c);
-        if (idx != -1) {
-            RobotBase* target = robots[idx].robot_instance;
-            res.emplace_back(target->m_character, r, c);
-        }
-        r += dr;
-        c += dc;
-    }
-    return res;
-}
-
-// Apply an attack originating from shooter index
-void apply_shot(vector<LoadedRobot>& robots, int shooter_idx, int shot_r, int shot_c, vector<vector<char>>& board) {
-    RobotBase* shooter = robots[shooter_idx].robot_instance;
-    WeaponType wt = shooter->get_weapon();
-
-    if (shot_r < 0 || shot_r >= BOARD_ROWS || shot_c < 0 || shot_c >= BOARD_COLS) {
-        cout << shooter->m_name << " fired an invalid shot.\n";
-        return;
-    }
-
-    auto damage_hit = [&](int target_idx, int dmg) {
-        if (target_idx < 0) return;
-        RobotBase* target = robots[target_idx].robot_instance;
-        if (!robots[target_idx].alive) return;
-
-        target->reduce_armor(1);
-        int newh = target->take_damage(dmg);
-
-        cout << "Shooting: " << shooter->m_name
-             << " hits " << target->m_name
-             << " for " << dmg << " damage. Health: " << newh << "\n";
-
-        if (newh <= 0) {
-            mark_robot_dead(robots[target_idx], board);
-            cout << target->m_name << " is dead.\n";
-        }
-    };
-
-    switch (wt) {
-        case railgun: {
-            int shooter_r, shooter_c;
-            shooter->get_current_location(shooter_r, shooter_c);
-
-            for (size_t i = 0; i < robots.size(); ++i) {
-                if (!robots[i].alive) continue;
-                if ((int)i == shooter_idx) continue;  // skip the shooter
-
-                int rr, cc;
-                robots[i].robot_instance->get_current_location(rr, cc);
-
-                // Hit if on the same row OR same column as the target
-                if (rr == shot_r || cc == shot_c) {
-                    damage_hit((int)i, 12);
-                }
-            }
-            break;
-        }
-
-
-        case flamethrower: {
-            // Mark the flamethrower area as flames and damage any robots inside.
-            // The existing loops already iterate the intended box: rows [shot_r-2 .. shot_r+1], cols [shot_c-1 .. shot_c+1]
-            for (int r = shot_r - 2; r <= shot_r + 1; ++r) {
-                for (int c = shot_c - 1; c <= shot_c + 1; ++c) {
-                    if (r < 0 || r >= BOARD_ROWS || c < 0 || c >= BOARD_COLS) continue;
-                    // Place flame on the board
-                    board[r][c] = FLAME_OBS;
-                    // If there's a robot there, damage it
-                    int idx = find_robot_at(robots, r, c);
-                    if (idx != -1) damage_hit(idx, 8);
-                }
-            }
-            break;
-        }
-
-        case grenade: {
-            if (shooter->get_grenades() <= 0) {
-                cout << shooter->m_name << " has no grenades left!\n";
-                break;
-            }
-            for (int r = shot_r - 1; r <= shot_r + 1; ++r) {
-                for (int c = shot_c - 1; c <= shot_c + 1; ++c) {
-                    if (r < 0 || r >= BOARD_ROWS || c < 0 || c >= BOARD_COLS) continue;
-                    int idx = find_robot_at(robots, r, c);
-                    if (idx != -1) damage_hit(idx, 18);
-                }
-            }
-            shooter->decrement_grenades();
-            break;
-        }
-        case hammer: {
-            int idx = find_robot_at(robots, shot_r, shot_c);
-            if (idx != -1) damage_hit(idx, 20);
-            break;
-        }
-    }
-}
-
-char get_under_cell(const vector<vector<char>>& board, int r, int c) {
-    char ch = board[r][c];
-    if (ch == FLAME_OBS || ch == PIT_OBS || ch == MOUND_OBS || ch == 'X') return ch;
-    return '.';
-}
-
-int main(int argc, char** argv) {
-    cout << "RobotWarz arena starting...\n";
-
-    // Discover Robot_*.cpp files
-    vector<string> robot_cpp_files;
-    for (auto &p : fs::directory_iterator(fs::current_path())) {
-        if (!p.is_regular_file()) continue;
-        string name = p.path().filename().string();
-        if (name.rfind("Robot_", 0) == 0 && name.size() > 6 && name.find(".cpp") != string::npos) {
-            robot_cpp_files.push_back(name);
-        }
-    }
-
-    if (robot_cpp_files.empty()) {
-        cerr << "No Robot_*.cpp files found in current directory.\n";
-        return 1;
-    }
-
-    vector<LoadedRobot> robots;
-    for (auto &cpp : robot_cpp_files) {
-        LoadedRobot lr;
-        lr.cpp_file = cpp;
-        if (!compile_robot(cpp, lr.so_file)) {
-            cerr << "Failed compiling " << cpp << " - skipping\n";
-            continue;
-        }
-
-        lr.handle = dlopen(lr.so_file.c_str(), RTLD_LAZY);
-        if (!lr.handle) {
-            cerr << "dlopen failed for " << lr.so_file << ": " << dlerror() << "\n";
-            continue;
-        }
-
-        RobotFactory create_robot = (RobotFactory)dlsym(lr.handle, "create_robot");
-        if (!create_robot) {
-            cerr << "dlsym create_robot failed in " << lr.so_file << ": " << dlerror() << "\n";
-            dlclose(lr.handle);
-            continue;
-        }
-
-        lr.robot_instance = create_robot();
-        if (!lr.robot_instance) {
-            cerr << "create_robot returned null for " << lr.so_file << "\n";
-            dlclose(lr.handle);
-            continue;
-        }
-
-        robots.push_back(move(lr));
-    }
-
-    if (robots.empty()) {
-        cerr << "No robots loaded successfully.\n";
-        return 1;
-    }
-
-    // Initialize board and obstacles
-    vector<vector<char>> board(BOARD_ROWS, vector<char>(BOARD_COLS, '.'));
-    place_obstacles(board);
-    place_robots_random(robots, board);
-
-    int round = 0;
-    const int MAX_ROUNDS = 5000;
-
-    while (true) {
-        cout << "\n=========== starting round " << round << " ===========\n";
-        
-
-        // --- Each robot takes a turn ---
-        for (size_t i = 0; i < robots.size(); ++i) {
-            if (!robots[i].alive || !robots[i].robot_instance) continue;
-
-            RobotBase* r = robots[i].robot_instance;
-            cout << "\n" << r->m_name << " " << r->m_character << " begins turn.\n";
-            cout << r->print_stats() << "\n";
-
-            // Radar scanning
-            vector<RadarObj> radar_results;
-            int radar_dir = 0;
-            r->get_radar_direction(radar_dir);
-
-            if (radar_dir == 0) {
-                int rr, rc;
-                r->get_current_location(rr, rc);
-                for (int dr = -1; dr <= 1; ++dr) {
-                    for (int dc = -1; dc <= 1; ++dc) {
-                        if (dr == 0 && dc == 0) continue;
-                        int nr = rr + dr, nc = rc + dc;
-                        if (nr < 0 || nr >= BOARD_ROWS || nc < 0 || nc >= BOARD_COLS) continue;
-                        int idx = find_robot_at(robots, nr, nc);
-                        if (idx != -1) radar_results.emplace_back(robots[idx].robot_instance->m_character, nr, nc);
-                    }
-                }
-            } else {
-                radar_results = do_radar_scan(r, radar_dir, board, robots);
-            }
-
-            r->process_radar_results(radar_results);
-
-            // Shooting
-            int shot_r = -1, shot_c = -1;
-            if (r->get_shot_location(shot_r, shot_c)) {
-                apply_shot(robots, (int)i, shot_r, shot_c, board);
-                if (!robots[i].alive) {
-                    int vr, vc;
-                    r->get_current_location(vr, vc);
-                    cout << r->m_name << " died from shooting damage. Skipping turn.\n";
-                    continue;
-                }
-            }
-
-            // --- Movement ---
-            if (!robots[i].can_move_flag) {
-                cout << r->m_name << " is trapped in a pit and cannot move.\n";
-                continue;
-            }
-
-            // Get move attempt
-            int move_dir = 0, move_dist = 0;
-            r->get_move_direction(move_dir, move_dist);
-
-            // Validate move attempt
-            if (move_dir < 1 || move_dir > 8 || move_dist <= 0 || move_dist > r->get_move_speed()) {
-                cout << r->m_name << " chose invalid move (" << move_dir << "," << move_dist << "). Staying put this turn.\n";
-                continue; // robot will try again next turn
-            }
-
-            // Attempt move
-            int cur_r, cur_c;
-            r->get_current_location(cur_r, cur_c);
-            int dr = directions[move_dir].first;
-            int dc = directions[move_dir].second;
-            int new_r = cur_r, new_c = cur_c;
-            bool blocked = false;
-
-            for (int step = 0; step < move_dist; ++step) {
-                int tr = new_r + dr;
-                int tc = new_c + dc;
-
-                if (tr < 0 || tr >= BOARD_ROWS || tc < 0 || tc >= BOARD_COLS
-                    || board[tr][tc] == MOUND_OBS || board[tr][tc] == 'X'
-                    || find_robot_at(robots, tr, tc) != -1) 
-                {
-                    blocked = true;
-                    break;
-                }
-
-                new_r = tr;
-                new_c = tc;
-            }
-
-            if (blocked) {
-                cout << "Moving: " << r->m_name << " blocked at (" << new_r << "," << new_c << "). Staying put this turn.\n";
-                board[cur_r][cur_c] = r->m_character; // leave robot in place
-                // do NOT set can_move_flag; robot will attempt again next turn
-            } else {
-                // Valid move
-                char landed_cell = board[new_r][new_c];
-                board[cur_r][cur_c] = get_under_cell(board, cur_r, cur_c);
-                r->move_to(new_r, new_c);
-                cout << "Moving: " << r->m_name << " moves to (" << new_r << "," << new_c << ").\n";
-
-                if (landed_cell == FLAME_OBS) {
-                    r->reduce_armor(1);
-                    int health = r->take_damage(8);
-                    if (health <= 0) {
-                        mark_robot_dead(robots[i], board);
-                        cout << r->m_name << " died in flames.\n";
-                        continue;
-                    }
-                }
-
-                board[new_r][new_c] = r->m_character;
-
-                if (landed_cell == PIT_OBS) {
-                    robots[i].can_move_flag = false; // only permanent if actually in pit
-                    r->disable_movement();
-                    cout << r->m_name << " fell into a pit and cannot move for the rest of the game!\n";
-                }
-            }
-
-
-            // Final alive check
-            int vr, vc;
-            r->get_current_location(vr, vc);
-            if (r->get_health() <= 0) {
-                mark_robot_dead(robots[i], board);
-                cout << r->m_name << " has died.\n";
-                continue;
-            } if (robots[i].alive) {
-                board[vr][vc] = r->m_character;
-            }
-        } // end robot loop
-
-        // --- End-of-round check ---
-        int alive_count = 0;
-        LoadedRobot* last_alive = nullptr;
-        for (auto &lr : robots) {
-            if (lr.alive) {
-                alive_count++;
-                last_alive = &lr; // keep track of last alive robot
-            }
-        }
-
-        if (alive_count <= 1 || round >= MAX_ROUNDS) {
-            cout << "\nGame over after " << round << " rounds.\n";
-
-            if (alive_count == 1 && last_alive && last_alive->robot_instance) {
-                cout << "Winner: " << last_alive->robot_instance->m_name
-                    << " (" << last_alive->robot_instance->m_character << ")!\n";
-            } else {
-                cout << "No winner.\n";
-            }
-
-            for (auto &lr : robots) {
-                int rr, cc;
-                if (lr.robot_instance) lr.robot_instance->get_current_location(rr, cc);
-                cout << lr.robot_instance->m_name << " (" << lr.robot_instance->m_character << ") "
-                    << (lr.alive ? "alive" : "dead") 
-                    << " at (" << rr << "," << cc << ")\n";
-            }
-            break;
-        }
-        
-        print_board(board);
-
-        cout << "\nPress ENTER to continue to the next round...";
-        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        cin.get(); // waits for ENTER
-
-        round++;
-    } // end while
-
-    // Cleanup
-    for (auto &lr : robots) {
-        if (lr.robot_instance) delete lr.robot_instance;
-        if (lr.handle) dlclose(lr.handle);
-    }
-
-    cout << "Exiting RobotWarzArena.\n";
-    return 0;
-}
+// RobotWarzArena: finds Robot_*.cpp in the current directory, builds and
+// loads them, then plays a single match, a batch of matches, a rating ladder,
+// a scaling sweep or a loadout sweep.
+#include <bits/stdc++.h>
+#include <filesystem>
+#include "Arena.h"
+#include "Heatmap.h"
+#include "Ladder.h"
+#include "LayoutCorpus.h"
+#include "Loadout.h"
+#include "MatchScheduler.h"
+#include "MatchServer.h"
+#include "ResultCache.h"
+#include "Spectator.h"
+#include "Sweep.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// --ladder N plays up to N rated duels instead of one free-for-all
+struct LadderOptions {
+    int games = 0;
+    double stable_rd = 60.0;
+    string file = "robotwarz_ladder.txt";
+};
+
+// --matches N plays N free-for-alls, each in its own forked worker, or with
+// --interleave K as coroutines, K at a time on each of --jobs threads
+struct BatchOptions {
+    int matches = 0;
+    int jobs = (int)max(1u, thread::hardware_concurrency());
+    int interleave = 0;
+};
+
+// --sweep CSV measures throughput over a grid of arena shapes
+struct SweepOptions {
+    string csv;
+    SweepGrid grid;
+};
+
+// --loadout FILE ranks every move/armor/weapon build of one robot
+struct LoadoutOptions {
+    string cpp_file;
+    int matches = 20;
+};
+
+// --cache FILE reuses stored results of batch, ladder and loadout matches
+struct CacheOptions {
+    string file;
+    double verify = 0;              // share of hits to replay and check
+};
+
+// --write-layouts FILE stores starting layouts for the board; --layouts FILE
+// plays game N from layout N
+struct LayoutOptions {
+    string write_file;
+    long long count = 1000;
+    int robots = 4;
+    string file;
+};
+
+// Helper: parse a comma-separated list such as "10,20,40"
+template <class T>
+vector<T> parse_list(const string& val) {
+    vector<T> out;
+    stringstream in(val);
+    string item;
+    while (getline(in, item, ',')) {
+        size_t used = 0;
+        out.push_back(is_integral_v<T> ? (T)stoi(item, &used) : (T)stod(item, &used));
+        if (used != item.size()) throw invalid_argument(item);
+    }
+    if (out.empty()) throw invalid_argument(val);
+    return out;
+}
+
+// Helper: parse command line options into the arena config
+bool parse_args(int argc, char** argv, ArenaConfig& cfg, LadderOptions& ladder, BatchOptions& batch,
+                SweepOptions& sweep, LoadoutOptions& loadout, CacheOptions& cache, LayoutOptions& layouts,
+                vector<string>& robot_paths, string& spectate, string& heatmap_file, bool& watch) {
+    cfg.seed = random_device{}();
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--headless") {
+            cfg.headless = true;
+            continue;
+        }
+        if (arg == "--quiet") {
+            cfg.quiet = true;
+            continue;
+        }
+        if (arg == "--watch") {
+            watch = true;
+            continue;
+        }
+        if (arg == "--tiebreak") {
+            cfg.tiebreak = true;
+            continue;
+        }
+        if (arg == "--usage") {
+            cfg.report_usage = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        string val = argv[++i];
+        try {
+            if (arg == "--rows") cfg.rows = stoi(val);
+            else if (arg == "--cols") cfg.cols = stoi(val);
+            else if (arg == "--flames") cfg.num_flames = stoi(val);
+            else if (arg == "--pits") cfg.num_pits = stoi(val);
+            else if (arg == "--mounds") cfg.num_mounds = stoi(val);
+            else if (arg == "--seed") cfg.seed = (unsigned)stoul(val);
+            else if (arg == "--metrics") cfg.metrics_file = val;
+            else if (arg == "--max-rounds") cfg.max_rounds = stoi(val);
+            else if (arg == "--stall-rounds") cfg.stall_rounds = stoi(val);
+            else if (arg == "--repeat-limit") cfg.repeat_limit = stoi(val);
+            else if (arg == "--ladder") ladder.games = stoi(val);
+            else if (arg == "--ladder-file") ladder.file = val;
+            else if (arg == "--stable-rd") ladder.stable_rd = stod(val);
+            else if (arg == "--matches") batch.matches = stoi(val);
+            else if (arg == "--jobs") batch.jobs = stoi(val);
+            else if (arg == "--interleave") batch.interleave = stoi(val);
+            else if (arg == "--robots") robot_paths.push_back(val);
+            else if (arg == "--spectate") spectate = val;
+            else if (arg == "--heatmap") heatmap_file = val;
+            else if (arg == "--trace") cfg.trace_file = val;
+            else if (arg == "--record-calls") cfg.call_trace_dir = val;
+            else if (arg == "--cpu-cap") cfg.cpu_cap_sec = stod(val) / 1000;
+            else if (arg == "--heap-cap") cfg.heap_cap_bytes = stoll(val) * 1024;
+            else if (arg == "--sweep") sweep.csv = val;
+            else if (arg == "--sweep-sizes") sweep.grid.sizes = parse_list<int>(val);
+            else if (arg == "--sweep-robots") sweep.grid.robot_counts = parse_list<int>(val);
+            else if (arg == "--sweep-density") sweep.grid.densities = parse_list<double>(val);
+            else if (arg == "--sweep-games") sweep.grid.games = stoi(val);
+            else if (arg == "--loadout") loadout.cpp_file = val;
+            else if (arg == "--loadout-matches") loadout.matches = stoi(val);
+            else if (arg == "--cache") cache.file = val;
+            else if (arg == "--cache-verify") cache.verify = stod(val);
+            else if (arg == "--write-layouts") layouts.write_file = val;
+            else if (arg == "--layout-count") layouts.count = stoll(val);
+            else if (arg == "--layout-robots") layouts.robots = stoi(val);
+            else if (arg == "--layouts") layouts.file = val;
+            else {
+                cerr << "Unknown option " << arg << "\n";
+                return false;
+            }
+        } catch (const exception&) {
+            cerr << "Bad value for " << arg << ": " << val << "\n";
+            return false;
+        }
+    }
+
+    if (cfg.rows < 10 || cfg.cols < 10) {
+        cerr << "Arena must be at least 10 x 10.\n";
+        return false;
+    }
+    if (cfg.max_rounds < 0 || cfg.stall_rounds < 0 || cfg.repeat_limit < 0) {
+        cerr << "Round limits cannot be negative.\n";
+        return false;
+    }
+    if (cfg.cpu_cap_sec < 0 || cfg.heap_cap_bytes < 0) {
+        cerr << "Resource caps cannot be negative.\n";
+        return false;
+    }
+    if (cfg.num_flames < 0 || cfg.num_pits < 0 || cfg.num_mounds < 0) {
+        cerr << "Obstacle counts cannot be negative.\n";
+        return false;
+    }
+    if (batch.jobs < 1) {
+        cerr << "--jobs must be at least 1.\n";
+        return false;
+    }
+    if (batch.interleave < 0 || (batch.interleave > 0 && batch.matches == 0)) {
+        cerr << "--interleave needs --matches and at least 1 match in flight.\n";
+        return false;
+    }
+    if (batch.matches > 0 && ladder.games > 0) {
+        cerr << "Choose either --matches or --ladder.\n";
+        return false;
+    }
+    if (ladder.games > 0 && !cfg.trace_file.empty()) {
+        cerr << "--trace records single matches or --matches batches, not the ladder.\n";
+        return false;
+    }
+    if ((batch.matches > 0 || !sweep.csv.empty()) && !spectate.empty()) {
+        cerr << "--spectate streams from this process and cannot follow forked --matches or --sweep workers.\n";
+        return false;
+    }
+    if (!loadout.cpp_file.empty()) {
+        if (batch.matches > 0 || ladder.games > 0 || !sweep.csv.empty() || !spectate.empty()) {
+            cerr << "--loadout runs its own tournaments, without --matches, --ladder, --sweep or --spectate.\n";
+            return false;
+        }
+        if (loadout.matches < 1) {
+            cerr << "--loadout-matches must be at least 1.\n";
+            return false;
+        }
+    }
+    if (!cfg.call_trace_dir.empty()
+        && (batch.matches > 0 || ladder.games > 0 || !sweep.csv.empty() || !loadout.cpp_file.empty())) {
+        cerr << "--record-calls records a single match.\n";
+        return false;
+    }
+    if (!cache.file.empty() && batch.matches == 0 && ladder.games == 0 && loadout.cpp_file.empty()) {
+        cerr << "--cache applies to --matches, --ladder and --loadout.\n";
+        return false;
+    }
+    if (layouts.count < 1 || layouts.robots < 1) {
+        cerr << "--layout-count and --layout-robots must be at least 1.\n";
+        return false;
+    }
+    if (!layouts.file.empty() && (!sweep.csv.empty() || !layouts.write_file.empty())) {
+        cerr << "--layouts fixes the board, so it cannot drive --sweep or --write-layouts.\n";
+        return false;
+    }
+    // Reloads happen between matches in this process, which only the ladder
+    // and forked batches have; interleaved matches share the libraries
+    if (watch && ((ladder.games == 0 && batch.matches == 0) || batch.interleave > 0)) {
+        cerr << "--watch reloads robots between --ladder or --matches games (not with --interleave).\n";
+        return false;
+    }
+    if (!heatmap_file.empty() && !sweep.csv.empty()) {
+        cerr << "--heatmap needs one board size, so it cannot follow --sweep.\n";
+        return false;
+    }
+    if (cache.verify < 0 || cache.verify > 1) {
+        cerr << "--cache-verify must be in [0, 1].\n";
+        return false;
+    }
+    if (!sweep.csv.empty()) {
+        if (batch.matches > 0 || ladder.games > 0) {
+            cerr << "--sweep runs on its own, without --matches or --ladder.\n";
+            return false;
+        }
+        for (int size : sweep.grid.sizes) {
+            if (size < 10) {
+                cerr << "--sweep-sizes must be at least 10.\n";
+                return false;
+            }
+        }
+        for (int count : sweep.grid.robot_counts) {
+            if (count < 1) {
+                cerr << "--sweep-robots must be at least 1.\n";
+                return false;
+            }
+        }
+        for (double density : sweep.grid.densities) {
+            if (density < 0 || density >= 1) {
+                cerr << "--sweep-density must be in [0, 1).\n";
+                return false;
+            }
+        }
+        if (sweep.grid.games < 1) {
+            cerr << "--sweep-games must be at least 1.\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    cout << "RobotWarz arena starting...\n";
+
+    ArenaConfig cfg;
+    LadderOptions ladder;
+    BatchOptions batch;
+    SweepOptions sweep;
+    LoadoutOptions loadout;
+    CacheOptions cache;
+    LayoutOptions layouts;
+    vector<string> robot_paths;
+    string spectate;
+    string heatmap_file;
+    bool watch = false;             // hot reload edited robots between matches
+    if (!parse_args(argc, argv, cfg, ladder, batch, sweep, loadout, cache, layouts, robot_paths, spectate,
+                    heatmap_file, watch)) {
+        cerr << "Usage: " << argv[0] << " [--rows N] [--cols N] [--flames N] [--pits N] [--mounds N]"
+             << " [--max-rounds N] [--stall-rounds N] [--repeat-limit N] [--tiebreak]"
+             << " [--seed N] [--headless] [--quiet] [--metrics FILE]"
+             << " [--ladder GAMES] [--ladder-file FILE] [--stable-rd RD] [--watch]"
+             << " [--matches N] [--jobs N] [--interleave K] [--robots DIR|FILE]..."
+             << " [--spectate SOCKET] [--trace FILE] [--record-calls DIR] [--heatmap FILE]"
+             << " [--usage] [--cpu-cap MS] [--heap-cap KB]"
+             << " [--sweep CSV] [--sweep-sizes N,...] [--sweep-robots N,...] [--sweep-density D,...]"
+             << " [--sweep-games N] [--loadout FILE] [--loadout-matches N]"
+             << " [--cache FILE] [--cache-verify FRACTION]"
+             << " [--write-layouts FILE] [--layout-count N] [--layout-robots N] [--layouts FILE]\n";
+        return 1;
+    }
+    cout << "Seed: " << cfg.seed << "\n";
+
+    // Layouts are drawn without any robots
+    if (!layouts.write_file.empty()) {
+        if (!write_layout_corpus(layouts.write_file, cfg, layouts.robots, (uint64_t)layouts.count)) return 1;
+        cout << "Wrote " << layouts.count << " layouts of " << cfg.rows << "x" << cfg.cols << " for "
+             << layouts.robots << " robots to " << layouts.write_file << " (seeds from " << cfg.seed << ")\n";
+        return 0;
+    }
+    LayoutCorpus corpus;
+    if (!layouts.file.empty()) {
+        if (!corpus.open(layouts.file)) return 1;
+        corpus.apply_board(cfg);
+        cfg.layouts = &corpus;
+    }
+
+    // Discover Robot_*.cpp files: the current directory unless --robots
+    // names directories or individual sources
+    if (robot_paths.empty()) robot_paths.push_back(".");
+    vector<string> robot_cpp_files;
+    vector<string> robot_dirs;      // where --watch picks up new robots
+    for (auto &path : robot_paths) {
+        if (!fs::is_directory(path)) {
+            robot_cpp_files.push_back(path);
+            continue;
+        }
+        robot_dirs.push_back(path);
+        vector<string> found;
+        for (auto &p : fs::directory_iterator(path)) {
+            if (!p.is_regular_file()) continue;
+            string name = p.path().filename().string();
+            if (name.rfind("Robot_", 0) == 0 && name.size() > 6 && name.find(".cpp") != string::npos) {
+                found.push_back(path == "." ? name : (fs::path(path) / name).string());
+            }
+        }
+        sort(found.begin(), found.end());
+        robot_cpp_files.insert(robot_cpp_files.end(), found.begin(), found.end());
+    }
+
+    // A loadout sweep plays its variants against everyone else
+    if (!loadout.cpp_file.empty()) {
+        error_code ec;
+        erase_if(robot_cpp_files, [&](const string& cpp) { return fs::equivalent(cpp, loadout.cpp_file, ec); });
+    }
+
+    if (robot_cpp_files.empty()) {
+        cerr << "No Robot_*.cpp files found.\n";
+        return 1;
+    }
+
+    vector<LoadedRobot> robots;
+    for (auto &cpp : robot_cpp_files) {
+        LoadedRobot lr;
+        lr.cpp_file = cpp;
+        if (load_robot(lr)) robots.push_back(move(lr));
+    }
+
+    if (robots.empty()) {
+        cerr << "No robots loaded successfully.\n";
+        return 1;
+    }
+
+    SpectatorServer spectator;
+    if (!spectate.empty()) {
+        if (!spectator.start(spectate, cfg.rows, cfg.cols, robots.size())) return 1;
+        cfg.spectator = &spectator;
+    }
+
+    ResultCache result_cache;
+    if (!cache.file.empty()) {
+        if (!result_cache.open(cache.file, cache.verify, cfg.seed)) return 1;
+        cfg.cache = &result_cache;
+    }
+
+    // Shared with forked batch workers, so it must exist before they do
+    Heatmap heatmap;
+    if (!heatmap_file.empty()) {
+        if (!heatmap.create(cfg.rows, cfg.cols)) return 1;
+        cfg.heatmap = &heatmap;
+    }
+
+    auto start = chrono::steady_clock::now();
+    bool ok;
+    if (ladder.games > 0) {
+        cfg.headless = true;
+        cfg.quiet = true;
+        RobotWatcher watcher;
+        bool watching = watch && watcher.start(robots, robot_dirs);
+        ok = run_ladder(robots, cfg, ladder.games, ladder.stable_rd, ladder.file,
+                        watching ? &watcher : nullptr);
+    } else if (!loadout.cpp_file.empty()) {
+        cfg.headless = true;
+        cfg.quiet = true;
+        ok = run_loadout_sweep(loadout.cpp_file, robots, cfg, loadout.matches, batch.jobs);
+    } else if (!sweep.csv.empty()) {
+        ok = run_sweep(robots, cfg, sweep.grid, sweep.csv);
+    } else if (batch.matches > 0) {
+        BatchSummary summary;
+        if (batch.interleave > 0) {
+            ok = run_interleaved(robots, cfg, batch.matches, batch.jobs, batch.interleave, summary);
+        } else {
+            RobotWatcher watcher;
+            bool watching = watch && watcher.start(robots, robot_dirs);
+            ok = run_batch(robots, cfg, batch.matches, batch.jobs, summary, true, watching ? &watcher : nullptr);
+        }
+        chrono::duration<double> batch_time = chrono::steady_clock::now() - start;
+        cout << "\n" << summary.played << " matches in " << fixed << setprecision(2)
+             << batch_time.count() << " s (" << summary.played / max(batch_time.count(), 1e-9)
+             << " matches/s, " << summary.rounds / max(batch_time.count(), 1e-9)
+             << " rounds/s, " << batch.jobs << " jobs)\n";
+        cout.unsetf(ios::fixed);
+        for (size_t i = 0; i < robots.size(); ++i)
+            cout << setw(24) << left << robots[i].cpp_file << right << " wins: " << summary.wins[i] << "\n";
+        cout << "draws: " << summary.draws << " (stalemates: " << summary.stalemates << ")"
+             << ", average rounds: " << (summary.played ? summary.rounds / summary.played : 0) << "\n";
+        if (summary.crashed) {
+            cout << "crashed workers: " << summary.crashed << "\n";
+            ok = false;
+        }
+    } else {
+        MatchResult result;
+        ok = run_match(robots, cfg, result);
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    if (cfg.cache) result_cache.print_summary();
+    if (cfg.heatmap) {
+        if (heatmap.write(heatmap_file))
+            cout << "Heatmap of " << heatmap.games() << " games written to " << heatmap_file << "\n";
+        else
+            ok = false;
+    }
+    write_metrics(cfg.metrics_file, elapsed.count());
+
+    // Cleanup
+    for (auto &lr : robots) unload_robot(lr);
+
+    if (!ok) return 1;
+    cout << "Exiting RobotWarzArena.\n";
+    return 0;
+}
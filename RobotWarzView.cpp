@@ -0,0 +1,135 @@
+// RobotWarzView: terminal viewer for a live arena started with --spectate.
+//
+// Wire format (text, one record per line, every frame ends with "E"):
+//   K round rows cols robots   keyframe: followed by `rows` lines of board
+//                              cells, then an R line for every robot
+//   D round                    delta: only what changed since the last frame
+//   C row col ch               one board cell
+//   R idx ch row col health armor alive
+//   W ch                       match over, won by ch ('-' for no winner)
+//   E                          end of frame
+#include <bits/stdc++.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Redraw at most this often; frames in between only update the model
+static const int MIN_REDRAW_MS = 33;
+
+struct RobotView {
+    char ch = '?';
+    int row = -1, col = -1, health = 0, armor = 0, alive = 0;
+};
+
+struct GameView {
+    int round = 0, rows = 0, cols = 0;
+    vector<string> grid;
+    vector<RobotView> robots;
+    char winner = 0;                // 0 while the match is running
+    int grid_lines_due = 0;         // board lines still to read for a keyframe
+};
+
+// Helper: apply one line of the stream; returns true at end of frame
+bool apply_line(GameView& view, const string& line) {
+    if (view.grid_lines_due > 0) {
+        view.grid[view.rows - view.grid_lines_due] = line;
+        view.grid_lines_due--;
+        return false;
+    }
+    istringstream in(line);
+    char kind = 0;
+    in >> kind;
+    if (kind == 'K') {
+        size_t robots = 0;
+        in >> view.round >> view.rows >> view.cols >> robots;
+        view.grid.assign(view.rows, string(view.cols, '.'));
+        view.robots.assign(robots, RobotView());
+        view.winner = 0;
+        view.grid_lines_due = view.rows;
+    } else if (kind == 'D') {
+        in >> view.round;
+    } else if (kind == 'C') {
+        int r, c;
+        char ch;
+        if (in >> r >> c >> ch && r >= 0 && r < view.rows && c >= 0 && c < view.cols) view.grid[r][c] = ch;
+    } else if (kind == 'R') {
+        size_t i;
+        RobotView rv;
+        if (in >> i >> rv.ch >> rv.row >> rv.col >> rv.health >> rv.armor >> rv.alive && i < view.robots.size())
+            view.robots[i] = rv;
+    } else if (kind == 'W') {
+        in >> view.winner;
+    } else if (kind == 'E') {
+        return true;
+    }
+    return false;
+}
+
+// Helper: redraw the whole screen
+void render(const GameView& view) {
+    string out = "\x1b[H\x1b[2J";
+    out += "RobotWarz  round " + to_string(view.round) + "\n\n";
+    for (auto &row : view.grid) {
+        for (char ch : row) {
+            out += ' ';
+            out += ch;
+        }
+        out += '\n';
+    }
+    out += '\n';
+    for (auto &rv : view.robots) {
+        out += string(1, rv.ch) + "  health " + to_string(rv.health) + "  armor " + to_string(rv.armor)
+             + "  at (" + to_string(rv.row) + "," + to_string(rv.col) + ")" + (rv.alive ? "" : "  dead") + "\n";
+    }
+    if (view.winner == '-') out += "\nGame over: no winner.\n";
+    else if (view.winner) out += string("\nGame over: ") + view.winner + " wins!\n";
+    cout << out << flush;
+}
+
+int main(int argc, char** argv) {
+    string path = argc > 1 ? argv[1] : "robotwarz.sock";
+
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        cerr << "Socket path too long: " << path << "\n";
+        return 1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof addr) < 0) {
+        cerr << "Could not connect to " << path << ": " << strerror(errno) << "\n";
+        cerr << "Usage: " << argv[0] << " [SOCKET]  (start the arena with --spectate SOCKET)\n";
+        return 1;
+    }
+
+    GameView view;
+    string buffer;
+    char chunk[65536];
+    auto last_draw = chrono::steady_clock::now() - chrono::hours(1);
+    bool dirty = false;
+    ssize_t n;
+    while ((n = read(fd, chunk, sizeof chunk)) > 0) {
+        buffer.append(chunk, n);
+        size_t start = 0, end;
+        while ((end = buffer.find('\n', start)) != string::npos) {
+            if (apply_line(view, buffer.substr(start, end - start))) dirty = true;
+            start = end + 1;
+        }
+        buffer.erase(0, start);
+
+        auto now = chrono::steady_clock::now();
+        bool due = now - last_draw >= chrono::milliseconds(MIN_REDRAW_MS);
+        if (dirty && (due || view.winner)) {
+            render(view);
+            last_draw = now;
+            dirty = false;
+        }
+    }
+    if (dirty) render(view);
+    close(fd);
+    cout << "Stream closed.\n";
+    return 0;
+}
@@ -1,294 +1,423 @@
-// Updated Robot_Teto.cpp
-#include "RobotBase.h"
-#include <cstdlib>
-#include <vector>
-#include <algorithm>
-#include <cmath>
-#include <limits>
-
-class Robot_Teto : public RobotBase {
-private:
-    // remember last radar results (targets and obstacles)
-    std::vector<RadarObj> last_scan;
-
-    // helper: distance squared
-    static int dist2(int r1, int c1, int r2, int c2) {
-        int dr = r1 - r2;
-        int dc = c1 - c2;
-        return dr*dr + dc*dc;
-    }
-
-    // helper: map (dr,dc) to direction index 1..8 using directions[] from RobotBase.h
-    static int dir_from_delta(int dr, int dc) {
-        for (int i = 1; i <= 8; ++i) {
-            if (directions[i].first == dr && directions[i].second == dc) return i;
-        }
-        return 0; // invalid
-    }
-
-    // choose nearest enemy in last_scan; returns index in last_scan or -1
-    int nearest_enemy_idx(int my_r, int my_c) const {
-        int best = -1;
-        int bestd = std::numeric_limits<int>::max();
-        for (size_t i = 0; i < last_scan.size(); ++i) {
-            const RadarObj &o = last_scan[i];
-            if (o.m_type == m_character) continue; // ignore self (shouldn't appear)
-            // treat uppercase as robots (assignment uses chars for robots)
-            if (!isalpha((unsigned char)o.m_type)) continue;
-            int d = dist2(my_r, my_c, o.m_row, o.m_col);
-            if (d < bestd) { bestd = d; best = (int)i; }
-        }
-        return best;
-    }
-
-    // check if a tile is a flame obstacle
-    bool is_flame_tile(int row, int col) const {
-        for (const auto &o : last_scan) {
-            if (o.m_row == row && o.m_col == col && o.m_type == 'F')
-                return true;
-        }
-        return false;
-    }
-
-    bool is_danger_cell(int row, int col) const {
-        for (auto &[dr, dc] : danger_cells)
-            if (dr == row && dc == col) return true;
-        return false;
-    }
-
-    std::vector<std::pair<int,int>> danger_cells;
-
-
-public:
-    Robot_Teto()
-        : RobotBase(1, 5, railgun) // sensible defaults: move=3, armor=2, default weapon=railgun
-    {
-        m_name = "Teto";
-        m_character = '4';
-        // health private: base ctor sets default health (as assignment requires)
-    }
-
-    // choose a radar direction: prefer direction towards nearest last-known enemy
-    void get_radar_direction(int &radar_direction) override {
-        int r, c;
-        get_current_location(r, c);
-        int idx = nearest_enemy_idx(r, c);
-        if (idx != -1) {
-            int tr = last_scan[idx].m_row;
-            int tc = last_scan[idx].m_col;
-            int dr = tr - r;
-            int dc = tc - c;
-            // normalize to -1,0,1
-            if (dr > 0) dr = 1; else if (dr < 0) dr = -1; else dr = 0;
-            if (dc > 0) dc = 1; else if (dc < 0) dc = -1; else dc = 0;
-            int d = dir_from_delta(dr, dc);
-            radar_direction = (d == 0) ? (rand() % 8 + 1) : d;
-            return;
-        }
-
-        // otherwise random scan
-        radar_direction = rand() % 8 + 1;
-    }
-
-    // store radar results for decision making
-    void process_radar_results(const std::vector<RadarObj> &radar_results) override {
-        last_scan = radar_results;
-        danger_cells.clear();
-
-        int my_r, my_c;
-        get_current_location(my_r, my_c);
-
-        for (const auto &o : last_scan) {
-            // Track flames directly
-            if (o.m_type == 'F') {
-                danger_cells.push_back({o.m_row, o.m_col});
-            }
-
-            // Track enemies as potential threats
-            if (isalpha((unsigned char)o.m_type) && o.m_type != m_character) {
-                int er = o.m_row;
-                int ec = o.m_col;
-
-                // Hammer danger: adjacent cells
-                for (int dr = -1; dr <= 1; ++dr) {
-                    for (int dc = -1; dc <= 1; ++dc) {
-                        int nr = er + dr;
-                        int nc = ec + dc;
-                        if (nr >= 0 && nr < m_board_row_max && nc >= 0 && nc < m_board_col_max)
-                            danger_cells.push_back({nr, nc});
-                    }
-                }
-
-                // Railgun danger: full row and full column
-                for (int i = 0; i < m_board_row_max; ++i)
-                    danger_cells.push_back({i, ec});
-                for (int j = 0; j < m_board_col_max; ++j)
-                    danger_cells.push_back({er, j});
-
-                // Flamethrower danger: 3x4 area in front of robot (approx)
-                for (int dr = -1; dr <= 1; ++dr) {
-                    for (int dc = 1; dc <= 4; ++dc) {
-                        int nr = er + dr;
-                        int nc = ec + dc; // assume robot faces “right” for simplicity
-                        if (nr >= 0 && nr < m_board_row_max && nc >= 0 && nc < m_board_col_max)
-                            danger_cells.push_back({nr, nc});
-                    }
-                }
-            }
-        }
-    }
-
-
-    // choose where to shoot this turn. Tries to pick meaningful target based on weapon and radar data.
-    bool get_shot_location(int &shot_row, int &shot_col) override {
-        int r, c;
-        get_current_location(r, c);
-
-        int idx = nearest_enemy_idx(r, c);
-        // if we see someone, target them intelligently
-        if (idx != -1) {
-            const RadarObj &target = last_scan[idx];
-
-            WeaponType w = get_weapon();
-
-            if (w == hammer) {
-                // prefer adjacent cell (one of 8 neighbors) that contains the robot
-                int dr = target.m_row - r;
-                int dc = target.m_col - c;
-                // clamp to -1..1
-                if (dr > 1) dr = 1; else if (dr < -1) dr = -1;
-                if (dc > 1) dc = 1; else if (dc < -1) dc = -1;
-                shot_row = r + dr;
-                shot_col = c + dc;
-                return true;
-            }
-
-            if (w == railgun) {
-                // railgun hits along a single row or column direction in arena.
-                // choose shot_row equal to target row so railgun will affect that row.
-                shot_row = target.m_row;
-                shot_col = target.m_col; // arena's railgun logic in apply_shot expects a row to match
-                return true;
-            }
-
-            if (w == flamethrower) {
-                // flamethrower affects a rectangular area; target the cell just in front of the robot towards enemy
-                int dr = target.m_row - r;
-                int dc = target.m_col - c;
-                if (dr > 0) dr = 1; else if (dr < 0) dr = -1; else dr = 0;
-                if (dc > 0) dc = 1; else if (dc < 0) dc = -1; else dc = 0;
-                // pick a cell 1 step toward enemy (if enemy adjacent, target their cell)
-                shot_row = r + dr;
-                shot_col = c + dc;
-                // ensure within bounds
-                if (shot_row < 0) shot_row = 0;
-                if (shot_col < 0) shot_col = 0;
-                if (shot_row >= m_board_row_max) shot_row = m_board_row_max - 1;
-                if (shot_col >= m_board_col_max) shot_col = m_board_col_max - 1;
-                return true;
-            }
-
-            if (w == grenade) {
-                // if grenades available, lob directly at the enemy coordinates to get 3x3 area
-                if (get_grenades() > 0) {
-                    shot_row = target.m_row;
-                    shot_col = target.m_col;
-                    return true;
-                }
-            }
-        }
-
-        // fallback: no visible enemy => random shooting chance for chaos (grenade or railgun)
-        WeaponType w = get_weapon();
-        if (w == grenade && get_grenades() > 0) {
-            shot_row = rand() % m_board_row_max;
-            shot_col = rand() % m_board_col_max;
-            return true;
-        }
-        if (w == railgun) {
-            // shoot across a random row
-            shot_row = rand() % m_board_row_max;
-            shot_col = rand() % m_board_col_max;
-            return true;
-        }
-
-        // otherwise don't shoot
-        return false;
-    }
-
-    // movement: move exactly ONE cell per turn toward nearest seen target; otherwise wander one cell
-    void get_move_direction(int &move_direction, int &move_distance) override {
-        int r, c;
-        get_current_location(r, c);
-
-        move_distance = 1;  // default one step
-
-        int idx = nearest_enemy_idx(r, c);
-        if (idx != -1) {
-            int tr = last_scan[idx].m_row;
-            int tc = last_scan[idx].m_col;
-
-            int dr = tr - r;
-            int dc = tc - c;
-
-            if (dr > 0) dr = 1; else if (dr < 0) dr = -1; else dr = 0;
-            if (dc > 0) dc = 1; else if (dc < 0) dc = -1; else dc = 0;
-
-            int d = dir_from_delta(dr, dc);
-
-            // Try the direct step toward enemy
-            if (d != 0) {
-                int nr = r + directions[d].first;
-                int nc = c + directions[d].second;
-
-                if (!is_flame_tile(nr, nc) && !is_danger_cell(nr, nc)) {
-                    move_direction = d;
-                    return;
-                }
-            }
-
-            // Otherwise choose the safest move that gets closer
-            std::vector<std::pair<int,int>> options;
-            for (int d2 = 1; d2 <= 8; ++d2) {
-                int nr = r + directions[d2].first;
-                int nc = c + directions[d2].second;
-
-                if (nr < 0 || nr >= m_board_row_max || nc < 0 || nc >= m_board_col_max)
-                    continue;
-                if (is_flame_tile(nr, nc) || is_danger_cell(nr, nc))
-                    continue;
-
-                int d2dist = dist2(nr, nc, tr, tc);
-                options.push_back({d2dist, d2});
-            }
-
-            if (!options.empty()) {
-                std::sort(options.begin(), options.end());
-                move_direction = options[0].second;
-                return;
-            }
-
-            // Surrounded or no safe move
-            move_direction = 0;
-            move_distance = 0;
-            return;
-        }
-
-        // No target: remain in place like HammerBro
-        move_direction = 0;
-        move_distance = 0;
-
-
-        // fallback: stay put
-        move_direction = 0;
-        move_distance = 0;
-    }
-
-
-    virtual ~Robot_Teto() {}
-};
-
-// factory
-extern "C" RobotBase* create_robot() {
-    return new Robot_Teto();
-}
+#include "RobotBase.h"
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <limits>
+
+// Teto keeps a small model of the arena rules (weapon footprints, what blocks
+// movement, burning cells, what an enemy radar can see) and each turn
+// searches its own (shot, move) pairs against the enemies' likely replies.
+// The search is anytime: it deepens the enemy reply model until the time
+// budget runs out and then plays the best pair from the deepest finished
+// level. The budget defaults to 200us per turn and can be changed with the
+// TETO_BUDGET_US environment variable. TETO_DEPTH=N searches to a fixed
+// depth instead, ignoring the clock, so replays and trace tests repeat.
+//
+// The arena's radar only reports robots, so the flame map is built from
+// Teto's own turns: cells its flamethrower set alight, and the cell under it
+// after a flamethrower-sized hit while it stood still. A robot stepping onto
+// a flame puts it out, so cells Teto lands on or sees a robot in are cleared.
+class Robot_Teto : public RobotBase {
+private:
+    // --- rules model (mirrors RobotWarzArena's apply_shot and movement) ---
+    static constexpr int RAILGUN_DAMAGE = 12;
+    static constexpr int FLAMETHROWER_DAMAGE = 8;
+    static constexpr int GRENADE_DAMAGE = 18;
+    static constexpr int HAMMER_DAMAGE = 20;
+    static constexpr int FLAME_CELL_DAMAGE = 8;     // landing on an F
+    static constexpr double REPLY_DAMAGE = 14.5;    // mean weapon damage of an unknown enemy
+    static constexpr int MAX_REPLY_DEPTH = 5;       // enemies move at most 5
+    static constexpr int ENEMY_MEMORY = 8;          // turns before a sighting is forgotten
+    static constexpr int BLOCK_MEMORY = 4;          // turns a failed move path is avoided
+
+    struct Enemy {
+        char id;
+        int row, col;
+        int seen_turn;
+    };
+
+    struct Shot {
+        bool fire;
+        int row, col;
+        double value;       // expected damage dealt minus damage to self
+    };
+
+    struct Move {
+        int dir, dist;
+        int row, col;       // where the model says we end up
+        double hazard;      // flame cost of landing there
+    };
+
+    std::vector<Enemy> enemies;
+    std::vector<char> burning;          // cells believed to hold a flame
+    std::vector<int> blocked_turn;      // last turn a move through the cell failed
+    int turn = 0;
+    long budget_us = 200;
+    int fixed_depth = 0;                // > 0: no deadline, always this deep
+
+    // last turn's request, to learn from what the arena did with it
+    int prev_row = -1, prev_col = -1;
+    int prev_dir = 0, prev_dist = 0;
+    int prev_health = 0;
+
+    // plan chosen in get_shot_location and played in get_move_direction
+    int plan_dir = 0, plan_dist = 0;
+
+    bool on_board(int r, int c) const {
+        return r >= 0 && r < m_board_row_max && c >= 0 && c < m_board_col_max;
+    }
+
+    int cell(int r, int c) const { return r * m_board_col_max + c; }
+
+    // everything the radar reports is a robot unless it is an obstacle code
+    bool is_robot_type(char t) const {
+        return t != m_character && t != 'X' && t != 'M' && t != 'F' && t != 'P' && t != '.';
+    }
+
+    // chance a remembered sighting is still where we saw it
+    double freshness(const Enemy& e) const {
+        return std::pow(0.7, turn - e.seen_turn);
+    }
+
+    bool enemy_at(int r, int c) const {
+        for (const auto &e : enemies)
+            if (e.row == r && e.col == c) return true;
+        return false;
+    }
+
+    bool blocks_movement(int r, int c) const {
+        if (!on_board(r, c)) return true;
+        if (turn - blocked_turn[cell(r, c)] <= BLOCK_MEMORY) return true;
+        return enemy_at(r, c);
+    }
+
+    // A robot's radar looks along the 8 lines through it, so (r,c) is
+    // visible from (er,ec) when they share a row, column or diagonal.
+    static bool in_sight(int er, int ec, int r, int c) {
+        int dr = r - er, dc = c - ec;
+        if (dr == 0 && dc == 0) return false;
+        return dr == 0 || dc == 0 || dr == dc || dr == -dc;
+    }
+
+    static int dir_toward(int dr, int dc) {
+        dr = (dr > 0) - (dr < 0);
+        dc = (dc > 0) - (dc < 0);
+        for (int i = 1; i <= 8; ++i) {
+            if (directions[i].first == dr && directions[i].second == dc) return i;
+        }
+        return 0;
+    }
+
+    // lazily size the map once the arena has told us the board size
+    void ensure_map() {
+        size_t cells = (size_t)m_board_row_max * m_board_col_max;
+        if (burning.size() != cells) {
+            burning.assign(cells, 0);
+            blocked_turn.assign(cells, std::numeric_limits<int>::min() / 2);
+        }
+    }
+
+    // Learn from last turn. A requested move that left us in place hit
+    // something somewhere along its path, so avoid that path for a while. A
+    // move that went through landed on a cell whose flame, if any, is now
+    // out. Standing still and losing exactly a flamethrower's damage means
+    // the cell under us was set alight; it keeps burning once we step off.
+    void learn_from_last_move(int r, int c) {
+        bool moved = prev_row != r || prev_col != c;
+        if (prev_dist > 0 && !moved && get_move_speed() > 0) {
+            for (int step = 1; step <= prev_dist; ++step) {
+                int br = r + directions[prev_dir].first * step;
+                int bc = c + directions[prev_dir].second * step;
+                if (on_board(br, bc)) blocked_turn[cell(br, bc)] = turn;
+            }
+        }
+        if (prev_row >= 0) {
+            if (moved) burning[cell(r, c)] = 0;
+            else if (prev_health - get_health() == FLAMETHROWER_DAMAGE) burning[cell(r, c)] = 1;
+        }
+        prev_dist = 0;
+    }
+
+    // --- candidate generation ---
+
+    // Damage a shot at (sr,sc) would do, using the arena's footprints.
+    // Footprint boxes that include our own cell hurt us too.
+    Shot score_shot(int sr, int sc, int my_r, int my_c) {
+        Shot s{true, sr, sc, 0.0};
+        if (!on_board(sr, sc)) {
+            s.value = -1.0;
+            return s;
+        }
+
+        auto in_box = [](int r, int c, int r0, int r1, int c0, int c1) {
+            return r >= r0 && r <= r1 && c >= c0 && c <= c1;
+        };
+
+        for (const auto &e : enemies) {
+            bool hit = false;
+            int dmg = 0;
+            switch (get_weapon()) {
+                case railgun:      hit = e.row == sr || e.col == sc; dmg = RAILGUN_DAMAGE; break;
+                case flamethrower: hit = in_box(e.row, e.col, sr - 2, sr + 1, sc - 1, sc + 1); dmg = FLAMETHROWER_DAMAGE; break;
+                case grenade:      hit = in_box(e.row, e.col, sr - 1, sr + 1, sc - 1, sc + 1); dmg = GRENADE_DAMAGE; break;
+                case hammer:       hit = e.row == sr && e.col == sc; dmg = HAMMER_DAMAGE; break;
+            }
+            if (hit) s.value += dmg * freshness(e);
+        }
+
+        if (get_weapon() == flamethrower && in_box(my_r, my_c, sr - 2, sr + 1, sc - 1, sc + 1))
+            s.value -= FLAMETHROWER_DAMAGE;
+        if (get_weapon() == grenade && in_box(my_r, my_c, sr - 1, sr + 1, sc - 1, sc + 1))
+            s.value -= GRENADE_DAMAGE;
+        return s;
+    }
+
+    std::vector<Shot> candidate_shots(int my_r, int my_c) {
+        std::vector<Shot> shots;
+        shots.push_back({false, -1, -1, 0.0});
+        if (get_weapon() == grenade && get_grenades() <= 0) return shots;
+
+        for (const auto &a : enemies) {
+            switch (get_weapon()) {
+                case railgun:
+                    // a railgun shot covers a whole row and a whole column
+                    for (const auto &b : enemies)
+                        shots.push_back(score_shot(a.row, b.col, my_r, my_c));
+                    break;
+                case flamethrower:
+                    for (int sr = a.row - 1; sr <= a.row + 2; ++sr)
+                        for (int sc = a.col - 1; sc <= a.col + 1; ++sc)
+                            shots.push_back(score_shot(sr, sc, my_r, my_c));
+                    break;
+                case grenade:
+                    for (int sr = a.row - 1; sr <= a.row + 1; ++sr)
+                        for (int sc = a.col - 1; sc <= a.col + 1; ++sc)
+                            shots.push_back(score_shot(sr, sc, my_r, my_c));
+                    break;
+                case hammer:
+                    shots.push_back(score_shot(a.row, a.col, my_r, my_c));
+                    break;
+            }
+        }
+        return shots;
+    }
+
+    // Resolve a move the way the arena does: any blocked step cancels the
+    // whole move and flames hurt on landing.
+    Move simulate_move(int dir, int dist, int my_r, int my_c) const {
+        Move m{dir, dist, my_r, my_c, 0.0};
+        for (int step = 1; step <= dist; ++step) {
+            int r = my_r + directions[dir].first * step;
+            int c = my_c + directions[dir].second * step;
+            if (blocks_movement(r, c)) {
+                m.row = my_r;
+                m.col = my_c;
+                return m;
+            }
+        }
+        m.row = my_r + directions[dir].first * dist;
+        m.col = my_c + directions[dir].second * dist;
+        if (burning[cell(m.row, m.col)]) m.hazard += FLAME_CELL_DAMAGE;
+        return m;
+    }
+
+    // our flamethrower shot at (sr,sc) leaves its whole box burning
+    void set_alight(int sr, int sc) {
+        for (int r = sr - 2; r <= sr + 1; ++r)
+            for (int c = sc - 1; c <= sc + 1; ++c)
+                if (on_board(r, c)) burning[cell(r, c)] = 1;
+    }
+
+    std::vector<Move> candidate_moves(int my_r, int my_c) {
+        std::vector<Move> moves;
+        moves.push_back({0, 0, my_r, my_c, 0.0});
+        for (int d = 1; d <= 8; ++d)
+            for (int dist = 1; dist <= get_move_speed(); ++dist)
+                moves.push_back(simulate_move(d, dist, my_r, my_c));
+        return moves;
+    }
+
+    // Expected damage at (r,c) if every enemy moves up to `depth` cells,
+    // each reachable cell equally likely, and then shoots if it can see us.
+    double reply_threat(int r, int c, int depth) const {
+        double threat = 0.0;
+        for (const auto &e : enemies) {
+            int seen = 0, options = 0;
+            for (int er = e.row - depth; er <= e.row + depth; ++er) {
+                for (int ec = e.col - depth; ec <= e.col + depth; ++ec) {
+                    if (!on_board(er, ec) || (er == r && ec == c)) continue;
+                    options++;
+                    if (in_sight(er, ec, r, c)) seen++;
+                }
+            }
+            if (options > 0) threat += REPLY_DAMAGE * freshness(e) * seen / options;
+        }
+        return threat;
+    }
+
+    // Anytime search over (shot, move) pairs; leaves the move in plan_*
+    // and returns the chosen shot.
+    Shot search(int my_r, int my_c) {
+        using clock = std::chrono::steady_clock;
+        auto deadline = clock::now() + std::chrono::microseconds(budget_us);
+
+        std::vector<Shot> shots = candidate_shots(my_r, my_c);
+        std::vector<Move> moves = candidate_moves(my_r, my_c);
+
+        // threat[m] from the deepest reply level that finished in time
+        std::vector<double> threat(moves.size(), 0.0), level(moves.size());
+        for (size_t m = 0; m < moves.size(); ++m)
+            threat[m] = reply_threat(moves[m].row, moves[m].col, 0);
+
+        int max_depth = fixed_depth > 0 ? std::min(fixed_depth, MAX_REPLY_DEPTH) : MAX_REPLY_DEPTH;
+        for (int depth = 1; depth <= max_depth; ++depth) {
+            bool finished = true;
+            for (size_t m = 0; m < moves.size(); ++m) {
+                if (fixed_depth == 0 && clock::now() >= deadline) {
+                    finished = false;
+                    break;
+                }
+                level[m] = reply_threat(moves[m].row, moves[m].col, depth);
+            }
+            if (!finished) break;
+            threat.swap(level);
+        }
+
+        // a flamethrower shot turns its box into flames we may walk into
+        auto burned = [&](const Shot& s, const Move& m) {
+            return get_weapon() == flamethrower && s.fire
+                && m.row >= s.row - 2 && m.row <= s.row + 1
+                && m.col >= s.col - 1 && m.col <= s.col + 1
+                && (m.row != my_r || m.col != my_c);
+        };
+
+        double best = -std::numeric_limits<double>::infinity();
+        Shot best_shot = shots[0];
+        plan_dir = 0;
+        plan_dist = 0;
+        for (const auto &s : shots) {
+            for (size_t m = 0; m < moves.size(); ++m) {
+                double value = s.value - threat[m] - moves[m].hazard;
+                if (burned(s, moves[m])) value -= FLAME_CELL_DAMAGE;
+                if (value > best) {
+                    best = value;
+                    best_shot = s;
+                    plan_dir = moves[m].dir;
+                    plan_dist = moves[m].dist;
+                }
+            }
+        }
+        return best_shot;
+    }
+
+public:
+    Robot_Teto()
+        : RobotBase(1, 5, railgun) // clamped by RobotBase to move=2, armor=5
+    {
+        m_name = "Teto";
+        m_character = '4';
+        // health private: base ctor sets default health (as assignment requires)
+
+        if (const char* env = std::getenv("TETO_BUDGET_US")) {
+            long us = std::atol(env);
+            if (us > 0) budget_us = us;
+        }
+        if (const char* env = std::getenv("TETO_DEPTH")) fixed_depth = std::atoi(env);
+    }
+
+    // choose a radar direction: prefer direction towards nearest remembered enemy
+    void get_radar_direction(int &radar_direction) override {
+        ensure_map();
+        turn++;
+
+        int r, c;
+        get_current_location(r, c);
+        learn_from_last_move(r, c);
+
+        // forget sightings that are too old to be useful
+        enemies.erase(std::remove_if(enemies.begin(), enemies.end(),
+                          [&](const Enemy& e) { return turn - e.seen_turn > ENEMY_MEMORY; }),
+                      enemies.end());
+
+        const Enemy* nearest = nullptr;
+        int bestd = std::numeric_limits<int>::max();
+        for (const auto &e : enemies) {
+            int d = std::max(std::abs(e.row - r), std::abs(e.col - c));
+            if (d < bestd) { bestd = d; nearest = &e; }
+        }
+
+        int d = nearest ? dir_toward(nearest->row - r, nearest->col - c) : 0;
+        radar_direction = (d == 0) ? (rand() % 8 + 1) : d;
+    }
+
+    // fold radar results into the enemy memory; a robot standing on a cell
+    // has put out any flame there
+    void process_radar_results(const std::vector<RadarObj> &radar_results) override {
+        ensure_map();
+        for (const auto &o : radar_results) {
+            if (!on_board(o.m_row, o.m_col) || !is_robot_type(o.m_type)) continue;
+            burning[cell(o.m_row, o.m_col)] = 0;
+
+            auto it = std::find_if(enemies.begin(), enemies.end(),
+                                   [&](const Enemy& e) { return e.id == o.m_type; });
+            if (it == enemies.end()) enemies.push_back({o.m_type, o.m_row, o.m_col, turn});
+            else *it = {o.m_type, o.m_row, o.m_col, turn};
+        }
+    }
+
+    // choose this turn's shot and move together with the lookahead search
+    bool get_shot_location(int &shot_row, int &shot_col) override {
+        ensure_map();
+        int r, c;
+        get_current_location(r, c);
+
+        Shot s = search(r, c);
+        if (s.fire && s.value > 0) {
+            shot_row = s.row;
+            shot_col = s.col;
+            if (get_weapon() == flamethrower) set_alight(s.row, s.col);
+            return true;
+        }
+
+        // fallback: nothing worth aiming at => random shooting chance for chaos (grenade or railgun)
+        WeaponType w = get_weapon();
+        if ((w == grenade && get_grenades() > 0 && enemies.empty()) || w == railgun) {
+            shot_row = rand() % m_board_row_max;
+            shot_col = rand() % m_board_col_max;
+            // don't lob a grenade onto ourselves
+            if (w == railgun || std::abs(shot_row - r) > 1 || std::abs(shot_col - c) > 1) return true;
+        }
+
+        // otherwise don't shoot
+        return false;
+    }
+
+    // movement: play the move picked by the search
+    void get_move_direction(int &move_direction, int &move_distance) override {
+        int r, c;
+        get_current_location(r, c);
+
+        move_direction = plan_dir;
+        move_distance = plan_dist;
+        if (get_move_speed() <= 0) {
+            move_direction = 0;
+            move_distance = 0;
+        }
+
+        prev_row = r;
+        prev_col = c;
+        prev_dir = move_direction;
+        prev_dist = move_distance;
+        prev_health = get_health();
+    }
+
+
+    virtual ~Robot_Teto() {}
+};
+
+// factory
+extern "C" RobotBase* create_robot() {
+    return new Robot_Teto();
+}
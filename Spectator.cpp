@@ -0,0 +1,274 @@
+// Spectator stream: lock-free round events in, Unix socket text stream out
+#include <bits/stdc++.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Spectator.h"
+
+using namespace std;
+
+// A viewer with this much unsent data gets no more deltas; it is resynced
+// with a keyframe once the backlog has drained
+static const size_t MAX_PENDING = 256 * 1024;
+static const int POLL_MS = 5;
+
+SpectatorServer::~SpectatorServer() {
+    stop();
+}
+
+bool SpectatorServer::start(const string& path, int rows, int cols, size_t robots) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        cerr << "Spectator socket path too long: " << path << "\n";
+        return false;
+    }
+    m_listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listen_fd < 0) {
+        cerr << "socket failed: " << strerror(errno) << "\n";
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    unlink(path.c_str()); // stale socket from an earlier run
+    if (bind(m_listen_fd, (sockaddr*)&addr, sizeof addr) < 0 || listen(m_listen_fd, 16) < 0) {
+        cerr << "Could not listen on " << path << ": " << strerror(errno) << "\n";
+        close(m_listen_fd);
+        m_listen_fd = -1;
+        return false;
+    }
+    m_path = path;
+    // a keyframe is one event per non-empty cell and per robot, plus two
+    size_t keyframe = (size_t)max(rows, 0) * max(cols, 0) + robots + 2;
+    m_ring.resize(bit_ceil(max(MIN_RING_SIZE, keyframe)));
+    m_ring_mask = m_ring.size() - 1;
+    m_thread = thread(&SpectatorServer::serve_loop, this);
+    cout << "Spectators can connect to " << path << "\n";
+    return true;
+}
+
+void SpectatorServer::stop() {
+    if (!m_thread.joinable()) return;
+    m_stop = true;
+    m_thread.join();
+    for (auto &v : m_viewers) close(v.fd);
+    m_viewers.clear();
+    close(m_listen_fd);
+    m_listen_fd = -1;
+    unlink(m_path.c_str());
+    if (m_dropped) cout << "Spectator: dropped " << m_dropped << " frames for slow viewers.\n";
+}
+
+// ---- producer side (match thread) ----
+
+bool SpectatorServer::push(const Event& e) {
+    size_t tail = m_tail.load(memory_order_relaxed);
+    if (tail - m_head.load(memory_order_acquire) >= m_ring.size()) return false;
+    m_ring[tail & m_ring_mask] = e;
+    m_tail.store(tail + 1, memory_order_release);
+    return true;
+}
+
+// Full state: the board's non-empty cells and every robot
+void SpectatorServer::push_keyframe(int round, const Board& board, const RobotTable& table,
+                                    const vector<LoadedRobot>& robots) {
+    int rows = board.rows(), cols = board.cols();
+    size_t needed = robots.size() + 2;
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+            if (board.at(r, c) != '.') needed++;
+    size_t used = m_tail.load(memory_order_relaxed) - m_head.load(memory_order_acquire);
+    if (needed > m_ring.size() - used) {
+        m_lost = true; // try again next round
+        return;
+    }
+
+    push({Event::KEYFRAME, 0, 0, rows, cols, (int32_t)robots.size(), round, 0});
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+            if (board.at(r, c) != '.') push({Event::CELL, board.at(r, c), 0, r, c, 0, 0, 0});
+    for (size_t i = 0; i < robots.size(); ++i) {
+        char ch = robots[i].robot_instance ? robots[i].robot_instance->m_character : '?';
+        push({Event::ROBOT, ch, (uint16_t)i, table.row[i], table.col[i],
+              table.health[i], table.armor[i], (uint8_t)table.alive[i]});
+    }
+    push({Event::ROUND_END, 0, 0, round, 0, 0, 0, 0});
+    m_lost = false;
+}
+
+void SpectatorServer::begin_match(Board& board, const RobotTable& table, const vector<LoadedRobot>& robots) {
+    board.enable_journal();
+    push_keyframe(0, board, table, robots);
+}
+
+void SpectatorServer::end_round(int round, Board& board, const RobotTable& table,
+                                const vector<LoadedRobot>& robots) {
+    if (m_lost) {
+        board.take_changes([](int, int, char) {});
+        push_keyframe(round, board, table, robots);
+        return;
+    }
+
+    bool ok = true;
+    board.take_changes([&](int r, int c, char ch) {
+        ok = push({Event::CELL, ch, 0, r, c, 0, 0, 0}) && ok;
+    });
+    for (size_t i = 0; i < robots.size(); ++i) {
+        char ch = robots[i].robot_instance ? robots[i].robot_instance->m_character : '?';
+        ok = push({Event::ROBOT, ch, (uint16_t)i, table.row[i], table.col[i],
+                   table.health[i], table.armor[i], (uint8_t)table.alive[i]}) && ok;
+    }
+    ok = push({Event::ROUND_END, 0, 0, round, 0, 0, 0, 0}) && ok;
+    if (!ok) m_lost = true;
+}
+
+void SpectatorServer::end_match(int round, int winner) {
+    push({Event::MATCH_END, 0, 0, winner, round, 0, 0, 0});
+}
+
+// ---- server side ----
+
+void SpectatorServer::serve_loop() {
+    vector<pollfd> fds;
+    while (!m_stop.load()) {
+        fds.clear();
+        fds.push_back({m_listen_fd, POLLIN, 0});
+        for (auto &v : m_viewers) {
+            short events = POLLIN;
+            if (v.sent < v.pending.size()) events |= POLLOUT;
+            fds.push_back({v.fd, events, 0});
+        }
+        poll(fds.data(), fds.size(), POLL_MS);
+
+        // Viewers only ever send to hang up; anything else is ignored
+        for (size_t i = 0; i < m_viewers.size(); ++i) {
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            char buf[256];
+            ssize_t n = recv(m_viewers[i].fd, buf, sizeof buf, MSG_DONTWAIT);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+                close(m_viewers[i].fd);
+                m_viewers[i].fd = -1;
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept4(m_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+                m_viewers.push_back({fd, "", 0, true});
+        }
+
+        drain();
+        flush_viewers();
+    }
+    // Let connected viewers see how the last match ended
+    drain();
+    flush_viewers();
+}
+
+void SpectatorServer::drain() {
+    size_t head = m_head.load(memory_order_relaxed);
+    size_t tail = m_tail.load(memory_order_acquire);
+    for (; head != tail; ++head) apply(m_ring[head & m_ring_mask]);
+    m_head.store(head, memory_order_release);
+}
+
+void SpectatorServer::apply(const Event& e) {
+    switch (e.kind) {
+    case Event::KEYFRAME:
+        m_rows = e.a;
+        m_cols = e.b;
+        m_round = e.d;
+        m_winner = -2;
+        m_grid.assign((size_t)m_rows * m_cols, '.');
+        m_robots.assign(e.c, RobotView());
+        m_delta.clear();
+        for (auto &v : m_viewers) v.needs_keyframe = true;
+        break;
+    case Event::CELL:
+        m_grid[(size_t)e.a * m_cols + e.b] = e.ch;
+        m_delta += "C " + to_string(e.a) + " " + to_string(e.b) + " " + e.ch + "\n";
+        break;
+    case Event::ROBOT: {
+        RobotView now{e.ch, e.a, e.b, e.c, e.d, e.alive != 0};
+        RobotView& was = m_robots[e.idx];
+        if (now.ch == was.ch && now.row == was.row && now.col == was.col && now.health == was.health
+            && now.armor == was.armor && now.alive == was.alive) break;
+        was = now;
+        m_delta += "R " + to_string(e.idx) + " " + e.ch + " " + to_string(e.a) + " " + to_string(e.b)
+                 + " " + to_string(e.c) + " " + to_string(e.d) + " " + to_string(now.alive) + "\n";
+        break;
+    }
+    case Event::ROUND_END:
+        m_round = e.a;
+        publish_frame();
+        break;
+    case Event::MATCH_END:
+        m_round = e.b;
+        m_winner = e.a;
+        m_delta += string("W ") + (e.a >= 0 ? m_robots[e.a].ch : '-') + "\n";
+        publish_frame();
+        break;
+    }
+}
+
+// Hand the finished round to every viewer that can take it
+void SpectatorServer::publish_frame() {
+    string frame = "D " + to_string(m_round) + "\n" + m_delta + "E\n";
+    m_delta.clear();
+    for (auto &v : m_viewers) {
+        if (v.needs_keyframe) continue;
+        if (v.pending.size() - v.sent > MAX_PENDING) {
+            v.needs_keyframe = true;
+            m_dropped++;
+            continue;
+        }
+        v.pending += frame;
+    }
+}
+
+string SpectatorServer::keyframe_text() const {
+    string out = "K " + to_string(m_round) + " " + to_string(m_rows) + " " + to_string(m_cols)
+               + " " + to_string(m_robots.size()) + "\n";
+    for (int r = 0; r < m_rows; ++r) {
+        out.append(&m_grid[(size_t)r * m_cols], m_cols);
+        out += "\n";
+    }
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        const RobotView& rv = m_robots[i];
+        out += "R " + to_string(i) + " " + rv.ch + " " + to_string(rv.row) + " " + to_string(rv.col)
+             + " " + to_string(rv.health) + " " + to_string(rv.armor) + " " + to_string(rv.alive) + "\n";
+    }
+    if (m_winner != -2) out += string("W ") + (m_winner >= 0 ? m_robots[m_winner].ch : '-') + "\n";
+    out += "E\n";
+    return out;
+}
+
+void SpectatorServer::flush_viewers() {
+    // Keyframes go out only between rounds, when the mirror is consistent
+    bool consistent = m_delta.empty() && m_rows > 0;
+    for (auto &v : m_viewers) {
+        if (v.fd < 0) continue;
+        if (v.needs_keyframe && consistent && v.sent == v.pending.size()) {
+            v.pending = keyframe_text();
+            v.sent = 0;
+            v.needs_keyframe = false;
+        }
+        while (v.sent < v.pending.size()) {
+            ssize_t n = send(v.fd, v.pending.data() + v.sent, v.pending.size() - v.sent,
+                             MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n > 0) {
+                v.sent += n;
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EINTR)) break;
+            close(v.fd);
+            v.fd = -1;
+            break;
+        }
+        if (v.fd >= 0 && v.sent == v.pending.size()) {
+            v.pending.clear();
+            v.sent = 0;
+        }
+    }
+    m_viewers.erase(remove_if(m_viewers.begin(), m_viewers.end(), [](const Viewer& v) { return v.fd < 0; }),
+                    m_viewers.end());
+}
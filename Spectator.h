@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Arena.h"
+#include "Board.h"
+#include "RobotTable.h"
+
+// Live spectator stream. The match loop publishes each round's changes as
+// fixed-size events into a single-producer/single-consumer ring; it never
+// blocks, locks or allocates. A server thread drains the ring, keeps its own
+// copy of the game and streams it to any number of viewers connected to a
+// Unix domain socket (see RobotWarzView.cpp for the client and the wire
+// format). A viewer that falls behind has frames dropped and is resynced
+// with a keyframe once it catches up, so viewers can never stall a match.
+class SpectatorServer
+{
+private:
+    struct Event {
+        enum Kind : uint8_t { KEYFRAME, CELL, ROBOT, ROUND_END, MATCH_END };
+        uint8_t kind;
+        char ch;
+        uint16_t idx;
+        int32_t a, b, c, d;
+        uint8_t alive;
+    };
+
+    struct RobotView {
+        char ch = '?';
+        int row = -1, col = -1, health = 0, armor = 0;
+        bool alive = false;
+    };
+
+    struct Viewer {
+        int fd;
+        std::string pending;        // bytes not yet accepted by the socket
+        size_t sent = 0;
+        bool needs_keyframe = true;
+    };
+
+    // ring: m_tail written by the match thread, m_head by the server thread.
+    // Its size is a power of two that fits a whole keyframe (see start()).
+    static constexpr size_t MIN_RING_SIZE = 1 << 16;
+    std::vector<Event> m_ring;
+    size_t m_ring_mask = 0;
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+    bool m_lost = false;            // producer dropped events; resync pending
+
+    // server thread state: mirror of the game and the open viewers
+    int m_listen_fd = -1;
+    std::string m_path;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    int m_rows = 0, m_cols = 0, m_round = 0;
+    int m_winner = -2;              // -2 while a match is running, -1 for no winner
+    std::vector<char> m_grid;
+    std::vector<RobotView> m_robots;
+    std::string m_delta;            // text of the round being assembled
+    std::vector<Viewer> m_viewers;
+    unsigned long long m_dropped = 0;
+
+    bool push(const Event& e);
+    void push_keyframe(int round, const Board& board, const RobotTable& table,
+                       const std::vector<LoadedRobot>& robots);
+
+    void serve_loop();
+    void drain();
+    void apply(const Event& e);
+    void publish_frame();
+    std::string keyframe_text() const;
+    void flush_viewers();
+
+public:
+    ~SpectatorServer();
+
+    // Listen on a Unix domain socket at path; false if that fails. The ring
+    // is sized for a keyframe of a rows x cols board with `robots` robots,
+    // so a dropped round can always be resynced.
+    bool start(const std::string& path, int rows, int cols, size_t robots);
+    void stop();
+
+    // Producer side, called from run_match() only
+    void begin_match(Board& board, const RobotTable& table, const std::vector<LoadedRobot>& robots);
+    void end_round(int round, Board& board, const RobotTable& table, const std::vector<LoadedRobot>& robots);
+    void end_match(int round, int winner);
+};
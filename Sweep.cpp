@@ -0,0 +1,178 @@
+// Scaling sweep: throughput and phase split across board size, robots and density
+#include <bits/stdc++.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Sweep.h"
+
+using namespace std;
+
+// What a sweep child sends back through its pipe
+struct PointStats {
+    int ok = 0;
+    int games = 0;
+    long long rounds = 0;
+    double wall = 0;
+    PhaseTimes times;
+    EngineCounters counters;        // the worker's, for the parent's metrics
+};
+
+// Accepts and drops everything, after the ostream has done the formatting
+class DiscardBuf : public streambuf
+{
+private:
+    char m_buf[4096];
+
+public:
+    DiscardBuf() { setp(m_buf, m_buf + sizeof m_buf); }
+
+protected:
+    int overflow(int ch) override {
+        setp(m_buf, m_buf + sizeof m_buf);
+        return traits_type::not_eof(ch);
+    }
+};
+
+// Helper: play one grid point's games in this (child) process
+PointStats play_point(vector<LoadedRobot>& roster, const ArenaConfig& cfg, int games) {
+    PointStats stats;
+    take_engine_counters();         // the parent's counts stay with the parent
+    DiscardBuf discard;
+    streambuf* saved_cout = cout.rdbuf(&discard);
+    auto start = chrono::steady_clock::now();
+    stats.ok = 1;
+    for (int g = 0; g < games; ++g) {
+        ArenaConfig game_cfg = cfg;
+        game_cfg.seed = cfg.seed + (unsigned)g;
+        game_cfg.phase_times = &stats.times;
+        MatchResult result;
+        if (!run_match(roster, game_cfg, result)) {
+            stats.ok = 0;
+            break;
+        }
+        stats.games++;
+        stats.rounds += result.rounds + 1;  // rounds are numbered from 0
+    }
+    stats.wall = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.counters = take_engine_counters();
+    cout.rdbuf(saved_cout);
+    return stats;
+}
+
+// Helper: run play_point in a child; the child's peak RSS comes back in rss_kb
+bool play_point_forked(vector<LoadedRobot>& roster, const ArenaConfig& cfg, int games,
+                       PointStats& stats, long& rss_kb) {
+    int fds[2];
+    if (pipe(fds) < 0) {
+        cerr << "pipe failed: " << strerror(errno) << "\n";
+        return false;
+    }
+    cout.flush();
+    cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        cerr << "fork failed: " << strerror(errno) << "\n";
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        PointStats s = play_point(roster, cfg, games);
+        bool sent = write(fds[1], &s, sizeof s) == (ssize_t)sizeof s;
+        close(fds[1]);
+        exit(sent ? 0 : 1);
+    }
+    close(fds[1]);
+    ssize_t got = 0, n;
+    while (got < (ssize_t)sizeof stats
+           && ((n = read(fds[0], (char*)&stats + got, sizeof stats - got)) > 0 || (n < 0 && errno == EINTR)))
+        if (n > 0) got += n;
+    close(fds[0]);
+
+    int status = 0;
+    rusage usage{};
+    while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {}
+    rss_kb = usage.ru_maxrss;
+    if (got != (ssize_t)sizeof stats) {
+        cerr << "Sweep worker ";
+        if (WIFSIGNALED(status)) cerr << "killed by signal " << WTERMSIG(status) << "\n";
+        else cerr << "exited with status " << WEXITSTATUS(status) << " without results\n";
+        return false;
+    }
+    return true;
+}
+
+bool run_sweep(vector<LoadedRobot>& robots, const ArenaConfig& cfg,
+               const SweepGrid& grid, const string& csv_path) {
+    ofstream csv(csv_path);
+    if (!csv) {
+        cerr << "Cannot write sweep results to " << csv_path << "\n";
+        return false;
+    }
+    csv << "rows,cols,robots,density,flames,pits,mounds,games,rounds,turns,wall_sec,"
+           "rounds_per_sec,turns_per_sec,peak_rss_kb,"
+           "robot_pct,radar_pct,shooting_pct,movement_pct,logging_pct\n";
+
+    ArenaConfig point_cfg = cfg;
+    point_cfg.headless = true;
+    point_cfg.quiet = false;        // log into DiscardBuf so logging is timed
+    point_cfg.spectator = nullptr;
+    point_cfg.trace_file.clear();
+
+    bool ok = true;
+    for (int size : grid.sizes) {
+        for (int count : grid.robot_counts) {
+            for (double density : grid.densities) {
+                long long cells = (long long)size * size;
+                int obstacles = (int)llround(density * cells);
+                point_cfg.rows = point_cfg.cols = size;
+                point_cfg.num_flames = obstacles * 10 / 22;
+                point_cfg.num_pits = obstacles * 2 / 22;
+                point_cfg.num_mounds = obstacles - point_cfg.num_flames - point_cfg.num_pits;
+                if (obstacles + count > cells) {
+                    cout << "Sweep " << size << "x" << size << ", " << count << " robots, density "
+                         << density << ": skipped, board too full\n";
+                    continue;
+                }
+
+                vector<LoadedRobot> roster;
+                for (int k = 0; k < count; ++k) roster.push_back(robots[k % robots.size()]);
+
+                PointStats stats;
+                long rss_kb = 0;
+                if (!play_point_forked(roster, point_cfg, grid.games, stats, rss_kb) || !stats.ok) {
+                    cerr << "Sweep point " << size << "x" << size << ", " << count << " robots, density "
+                         << density << " failed.\n";
+                    ok = false;
+                    continue;
+                }
+                add_engine_counters(stats.counters);
+
+                const PhaseTimes& t = stats.times;
+                double total = max(t.total, 1e-9);
+                double logging = max(0.0, t.total - t.robot - t.radar - t.shooting - t.movement);
+                double wall = max(stats.wall, 1e-9);
+                auto pct = [&](double part) { return 100.0 * part / total; };
+                csv << size << "," << size << "," << count << "," << density << ","
+                    << point_cfg.num_flames << "," << point_cfg.num_pits << "," << point_cfg.num_mounds << ","
+                    << stats.games << "," << stats.rounds << "," << t.turns << ","
+                    << fixed << setprecision(4) << stats.wall << ","
+                    << setprecision(1) << stats.rounds / wall << "," << t.turns / wall << ","
+                    << rss_kb << "," << setprecision(2)
+                    << pct(t.robot) << "," << pct(t.radar) << "," << pct(t.shooting) << ","
+                    << pct(t.movement) << "," << pct(logging) << "\n";
+                csv.unsetf(ios::fixed);
+                csv << setprecision(6);
+
+                cout << "Sweep " << size << "x" << size << ", " << count << " robots, density " << density
+                     << ": " << fixed << setprecision(0) << stats.rounds / wall << " rounds/s, "
+                     << t.turns / wall << " turns/s, " << rss_kb << " KB peak\n";
+                cout.unsetf(ios::fixed);
+                cout << setprecision(6);
+            }
+        }
+    }
+    cout << "Sweep results written to " << csv_path << "\n";
+    return ok;
+}
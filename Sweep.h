@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Arena.h"
+
+// Grid for a scaling sweep: every size x robot count x density combination
+struct SweepGrid {
+    std::vector<int> sizes{10, 20, 40, 80, 160};    // square boards, side length
+    std::vector<int> robot_counts{2, 4, 8, 16};
+    std::vector<double> densities{0.05, 0.10, 0.20};    // share of cells with obstacles
+    int games = 3;                  // matches per grid point, seeds cfg.seed, cfg.seed + 1, ...
+};
+
+// Play every point of the grid and write one CSV row per point to csv_path:
+// rounds/s, turns/s, peak RSS and the share of round time spent in robot
+// code, radar, shooting, movement and the rest (logging and bookkeeping).
+// Obstacles are split between flames, pits and mounds like the default
+// layout (10:2:10). Rosters larger than the loaded robots reuse them in
+// order. Each point runs in a fork()ed child so its peak RSS is its own.
+// The game log is formatted into a discarding buffer, so logging costs what
+// it would writing to a file.
+bool run_sweep(std::vector<LoadedRobot>& robots, const ArenaConfig& cfg,
+               const SweepGrid& grid, const std::string& csv_path);
@@ -0,0 +1,101 @@
+// TraceDiff: compare two arena traces (RobotWarzArena --trace) and report
+// the first divergence with the boards around it. Exit status 0 when the
+// traces match, 1 when they diverge, 2 when a trace cannot be read.
+#include <bits/stdc++.h>
+
+using namespace std;
+
+// Helper: read a whole trace, one entry per line
+bool read_trace(const string& path, vector<string>& lines) {
+    ifstream in(path);
+    if (!in) {
+        cerr << "Cannot read trace " << path << "\n";
+        return false;
+    }
+    string line;
+    while (getline(in, line)) lines.push_back(line);
+    return true;
+}
+
+// Helper: index of the "B" board dump at or before line i (-1 if none)
+long find_board_before(const vector<string>& lines, size_t i) {
+    for (long k = (long)min(i, lines.size()); k-- > 0;) {
+        if (lines[k].rfind("B ", 0) == 0) return k;
+    }
+    return -1;
+}
+
+// Helper: index of the first "B" board dump after line i (-1 if none)
+long find_board_after(const vector<string>& lines, size_t i) {
+    for (size_t k = i; k < lines.size(); ++k) {
+        if (lines[k].rfind("B ", 0) == 0) return (long)k;
+    }
+    return -1;
+}
+
+// Helper: the board rows that follow the "B" line at index b
+vector<string> board_rows(const vector<string>& lines, long b, int rows) {
+    vector<string> out;
+    for (long k = b + 1; b >= 0 && k <= b + rows && k < (long)lines.size(); ++k) out.push_back(lines[k]);
+    return out;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " REFERENCE_TRACE CANDIDATE_TRACE\n";
+        return 2;
+    }
+    vector<string> ref, cand;
+    if (!read_trace(argv[1], ref) || !read_trace(argv[2], cand)) return 2;
+
+    // Board dumps are as tall as the header ("M seed rows cols robots") says
+    int rows = 0;
+    if (!ref.empty()) {
+        istringstream header(ref[0]);
+        string kind;
+        unsigned seed;
+        header >> kind >> seed >> rows;
+    }
+
+    size_t i = 0;
+    while (i < ref.size() && i < cand.size() && ref[i] == cand[i]) ++i;
+    if (i == ref.size() && i == cand.size()) return 0;
+
+    cout << "Traces diverge at line " << i + 1 << " (" << argv[1] << " vs " << argv[2] << "):\n";
+    cout << "  reference: " << (i < ref.size() ? ref[i] : "<end of trace>") << "\n";
+    cout << "  candidate: " << (i < cand.size() ? cand[i] : "<end of trace>") << "\n";
+
+    // The last board both agreed on, then each side's board after the
+    // round that diverged
+    long common = find_board_before(ref, i);
+    long ref_next = find_board_after(ref, i), cand_next = find_board_after(cand, i);
+    if (common >= 0 && (long)i <= common + rows) {
+        // the divergence is inside a board dump: show that dump from both sides
+        ref_next = cand_next = common;
+        common = find_board_before(ref, common);
+    }
+    if (common >= 0) {
+        cout << "\nLast agreed board (" << ref[common] << "):\n";
+        for (auto &row : board_rows(ref, common, rows)) cout << "  " << row << "\n";
+    }
+    vector<string> ref_rows = board_rows(ref, ref_next, rows);
+    vector<string> cand_rows = board_rows(cand, cand_next, rows);
+    if (!ref_rows.empty() || !cand_rows.empty()) {
+        size_t width = 0;
+        for (auto &row : ref_rows) width = max(width, row.size());
+        width = max(width, string("reference").size());
+        cout << "\nAfter the diverging round (reference | candidate, '^' marks differences):\n";
+        cout << "  " << left << setw(width) << "reference" << " | candidate\n";
+        for (size_t r = 0; r < max(ref_rows.size(), cand_rows.size()); ++r) {
+            string a = r < ref_rows.size() ? ref_rows[r] : "";
+            string b = r < cand_rows.size() ? cand_rows[r] : "";
+            string marks;
+            for (size_t c = 0; c < max(a.size(), b.size()); ++c)
+                marks += (c < a.size() && c < b.size() && a[c] == b[c]) ? ' ' : '^';
+            cout << "  " << left << setw(width) << a << " | " << b;
+            if (marks.find('^') != string::npos) cout << "   " << marks;
+            cout << "\n";
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+// Zobrist keys are generated on the fly with splitmix64 instead of being
+// stored in a table, so they cost no memory on arbitrarily large boards.
+constexpr unsigned long long zobrist_mix(unsigned long long x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Key for character ch sitting in cell idx. Empty cells contribute nothing.
+inline unsigned long long zobrist_cell_key(long long idx, char ch) {
+    if (ch == '.') return 0;
+    return zobrist_mix(((unsigned long long)idx << 8) | (unsigned char)ch);
+}
+
+// Key for one live robot's state
+inline unsigned long long zobrist_robot_key(int idx, int row, int col, int health, int armor, int grenades) {
+    unsigned long long h = zobrist_mix(0x526f626f74ULL ^ (unsigned long long)idx);
+    h = zobrist_mix(h ^ (((unsigned long long)(unsigned)row << 32) | (unsigned)col));
+    h = zobrist_mix(h ^ (((unsigned long long)(unsigned)health << 32) | (unsigned)armor));
+    return zobrist_mix(h ^ (unsigned)grenades);
+}
+
+// Counts how often each state hash has been seen since the last reset.
+// Open addressing over a buffer sized once up front; reset() just bumps a
+// generation number, so nothing is allocated or cleared per round.
+class RepetitionTable
+{
+private:
+    struct Slot {
+        unsigned long long hash = 0;
+        unsigned generation = 0;
+        int count = 0;
+    };
+    std::vector<Slot> m_slots;
+    unsigned m_generation = 1;
+    int m_used = 0;
+
+public:
+    explicit RepetitionTable(int capacity_pow2 = 4096) : m_slots(capacity_pow2) {}
+
+    void reset() {
+        m_generation++;
+        m_used = 0;
+    }
+
+    // Records one more sighting of hash and returns how many times it has been seen
+    int record(unsigned long long hash) {
+        // never let the table fill up: forget the history instead
+        if (m_used * 2 >= (int)m_slots.size()) reset();
+
+        size_t mask = m_slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& s = m_slots[i];
+            if (s.generation != m_generation) {
+                s.hash = hash;
+                s.generation = m_generation;
+                s.count = 1;
+                m_used++;
+                return 1;
+            }
+            if (s.hash == hash) return ++s.count;
+        }
+    }
+};
@@ -0,0 +1,91 @@
+// Sparring robot for the bundled benchmark tournament (make pgo): charges and hammers
+#include "RobotBase.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+class Robot_Brawler : public RobotBase {
+private:
+    int target_row = -1;
+    int target_col = -1;
+    int sweep = 0;
+
+    // helper: step of -1, 0 or 1 towards v
+    static int sign(int v) { return (v > 0) - (v < 0); }
+
+    // helper: direction index 1..8 for a unit step
+    static int dir_from_delta(int dr, int dc) {
+        for (int i = 1; i <= 8; ++i) {
+            if (directions[i].first == dr && directions[i].second == dc) return i;
+        }
+        return 0;
+    }
+
+    // helper: radar reports robots by their character; anything else is
+    // terrain, a wreck or this robot
+    bool is_enemy(char type) const {
+        return type != '.' && type != 'M' && type != 'F' && type != 'P' && type != 'X' && type != m_character;
+    }
+
+public:
+    Robot_Brawler() : RobotBase(4, 1, hammer) {
+        m_name = "Brawler";
+        m_character = 'W';
+    }
+
+    // look where the last target was, otherwise sweep round the compass
+    void get_radar_direction(int& radar_direction) override {
+        int r, c;
+        get_current_location(r, c);
+        int d = target_row < 0 ? 0 : dir_from_delta(sign(target_row - r), sign(target_col - c));
+        if (d == 0) {
+            sweep = sweep % 8 + 1;
+            d = sweep;
+        }
+        radar_direction = d;
+    }
+
+    // keep the closest robot seen
+    void process_radar_results(const std::vector<RadarObj>& radar_results) override {
+        int r, c;
+        get_current_location(r, c);
+        int best = -1;
+        target_row = target_col = -1;
+        for (const auto& o : radar_results) {
+            if (!is_enemy(o.m_type)) continue;
+            int d = std::abs(o.m_row - r) + std::abs(o.m_col - c);
+            if (best < 0 || d < best) {
+                best = d;
+                target_row = o.m_row;
+                target_col = o.m_col;
+            }
+        }
+    }
+
+    bool get_shot_location(int& shot_row, int& shot_col) override {
+        if (target_row < 0) return false;
+        int r, c;
+        get_current_location(r, c);
+        if (std::abs(target_row - r) > 1 || std::abs(target_col - c) > 1) return false;
+        shot_row = target_row;
+        shot_col = target_col;
+        return true;
+    }
+
+    void get_move_direction(int& direction, int& distance) override {
+        int r, c;
+        get_current_location(r, c);
+        if (target_row < 0) {
+            direction = rand() % 8 + 1;
+            distance = 1;
+            return;
+        }
+        direction = dir_from_delta(sign(target_row - r), sign(target_col - c));
+        int gap = std::max(std::abs(target_row - r), std::abs(target_col - c)) - 1;
+        distance = std::max(0, std::min(gap, get_move_speed()));
+    }
+};
+
+extern "C" RobotBase* create_robot() {
+    return new Robot_Brawler();
+}